@@ -0,0 +1,28 @@
+# Keep rules applied to the app's R8/ProGuard run for this library. They cover
+# what the bridge reaches by name; the SDK aars ship the rules for their own code.
+
+# JNI entry points of libappyarnpackage are bound by class and method name.
+-keepclasseswithmembernames,includedescriptorclasses class com.demoproject.** {
+    native <methods>;
+}
+
+# Called from C++ through GetMethodID (cpp-adapter.cpp).
+-keep class com.demoproject.AppYarnPackageJSI {
+    void setup(boolean, boolean, boolean, boolean, boolean, boolean, boolean, int, long);
+    boolean isReady();
+    void pay(int, java.lang.String, java.lang.String, java.lang.String, java.lang.String, java.lang.String, java.lang.String, long);
+}
+-keep interface com.demoproject.PaymentScheduler$Job { *; }
+-keep class * implements com.demoproject.PaymentScheduler$Job {
+    void start();
+    void drop(int, java.lang.String);
+}
+-keep interface com.demoproject.StandInBackend$Listener { *; }
+-keep class * implements com.demoproject.StandInBackend$Listener {
+    void onResult(int, java.lang.String);
+}
+
+# Methods of the legacy module are looked up by reflection.
+-keepclassmembers class com.demoproject.AppYarnPackageModule {
+    @com.facebook.react.bridge.ReactMethod <methods>;
+}
@@ -0,0 +1,408 @@
+#include <jni.h>
+#include <fbjni/fbjni.h>
+#include <jsi/jsi.h>
+#include <ReactCommon/CallInvokerHolder.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "LatencyHistogram.h"
+#include "PaymentScheduler.h"
+#include "SPayBridge.h"
+#include "SPayHostObject.h"
+#include "ScriptedPlatformBackend.h"
+
+using namespace spaybridge;
+namespace jni = facebook::jni;
+
+namespace {
+
+// Forwards backend calls to com.demoproject.AppYarnPackageJSI, which talks to
+// SPaySdkApp. Results come back through the nativeOn*Result entry points below,
+// matched to the pending C++ callback by id. Detached once its module instance
+// is invalidated: the owner, and with it the React context, is released, new
+// calls are answered right away and pending ones still get their results.
+class AndroidPlatformBackend : public PlatformBackend {
+public:
+  explicit AndroidPlatformBackend(jobject owner) {
+    JNIEnv *env = jni::Environment::current();
+    owner_ = env->NewGlobalRef(owner);
+    jclass cls = env->GetObjectClass(owner_);
+    setupMethod_ = env->GetMethodID(cls, "setup", "(ZZZZZZZIJ)V");
+    isReadyMethod_ = env->GetMethodID(cls, "isReady", "()Z");
+    payMethod_ = env->GetMethodID(cls, "pay",
+                                  "(ILjava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;"
+                                  "Ljava/lang/String;Ljava/lang/String;J)V");
+    env->DeleteLocalRef(cls);
+  }
+
+  ~AndroidPlatformBackend() override {
+    detach();
+  }
+
+  void detach() {
+    jobject owner;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      owner = std::exchange(owner_, nullptr);
+    }
+    if (owner != nullptr) {
+      jni::ThreadScope scope;
+      jni::Environment::current()->DeleteGlobalRef(owner);
+    }
+  }
+
+  // Whether the backend is detached and no SDK call is left to answer.
+  bool isDone() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return owner_ == nullptr && setupCallbacks_.empty() && paymentCallbacks_.empty();
+  }
+
+  void setup(const SetupConfig &config, SetupCallback callback) override {
+    JNIEnv *env = jni::Environment::current();
+    jlong id = nextId_++;
+    jobject owner = retainOwner(env);
+    if (owner == nullptr) {
+      callback(std::string(kDetachedMessage));
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      setupCallbacks_[id] = std::move(callback);
+    }
+    env->CallVoidMethod(owner, setupMethod_, config.bnplPlan, config.resultViewNeeded, config.helpers,
+                        config.needLogs, config.sbp, config.creditCard, config.debitCard,
+                        static_cast<jint>(config.environment), id);
+    env->DeleteLocalRef(owner);
+  }
+
+  bool isReady() override {
+    JNIEnv *env = jni::Environment::current();
+    jobject owner = retainOwner(env);
+    if (owner == nullptr) {
+      return false;
+    }
+    bool isReady = env->CallBooleanMethod(owner, isReadyMethod_);
+    env->DeleteLocalRef(owner);
+    return isReady;
+  }
+
+  void pay(PayMethod method, const PaymentRequest &request, PaymentCallback callback) override {
+    JNIEnv *env = jni::Environment::current();
+    jlong id = nextId_++;
+    jobject owner = retainOwner(env);
+    if (owner == nullptr) {
+      PaymentOutcome outcome;
+      outcome.info = kDetachedMessage;
+      outcome.category = ErrorCategory::Internal;
+      callback(outcome);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      paymentCallbacks_[id] = std::move(callback);
+    }
+    jstring merchantLogin = env->NewStringUTF(request.merchantLogin.c_str());
+    jstring bankInvoiceId = env->NewStringUTF(request.bankInvoiceId.c_str());
+    jstring orderNumber = env->NewStringUTF(request.orderNumber.c_str());
+    jstring language = env->NewStringUTF(request.language.c_str());
+    jstring redirectUri = env->NewStringUTF(request.redirectUri.c_str());
+    jstring apiKey = env->NewStringUTF(request.apiKey.c_str());
+    env->CallVoidMethod(owner, payMethod_, static_cast<jint>(method), merchantLogin, bankInvoiceId, orderNumber,
+                        language, redirectUri, apiKey, id);
+    for (jstring value : {merchantLogin, bankInvoiceId, orderNumber, language, redirectUri, apiKey}) {
+      env->DeleteLocalRef(value);
+    }
+    env->DeleteLocalRef(owner);
+  }
+
+  void onSetupResult(jlong id, std::optional<std::string> error) {
+    SetupCallback callback;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = setupCallbacks_.find(id);
+      if (it == setupCallbacks_.end()) {
+        return;
+      }
+      callback = std::move(it->second);
+      setupCallbacks_.erase(it);
+    }
+    callback(error);
+  }
+
+  void onPaymentResult(jlong id, const PaymentOutcome &outcome) {
+    PaymentCallback callback;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = paymentCallbacks_.find(id);
+      if (it == paymentCallbacks_.end()) {
+        return;
+      }
+      callback = it->second;
+      if (isFinal(outcome.state)) {
+        paymentCallbacks_.erase(it);
+      }
+    }
+    callback(outcome);
+  }
+
+private:
+  static constexpr const char *kDetachedMessage = "The React instance was torn down";
+
+  // A local ref keeps the owner usable outside the lock even if detach() runs
+  // meanwhile; nullptr once detached.
+  jobject retainOwner(JNIEnv *env) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return owner_ == nullptr ? nullptr : env->NewLocalRef(owner_);
+  }
+
+  jobject owner_;
+  jmethodID setupMethod_;
+  jmethodID isReadyMethod_;
+  jmethodID payMethod_;
+  std::atomic<jlong> nextId_{1};
+  std::mutex mutex_;
+  std::unordered_map<jlong, SetupCallback> setupCallbacks_;
+  std::unordered_map<jlong, PaymentCallback> paymentCallbacks_;
+};
+
+// One per AppYarnPackageJSI instance, i.e. per React instance. The bridge is
+// owned by the host object in that instance's runtime.
+struct Installation {
+  std::shared_ptr<AndroidPlatformBackend> backend;
+  std::weak_ptr<SPayBridge> bridge;
+};
+
+std::mutex gMutex;
+std::unordered_map<jlong, Installation> gInstallations;
+jlong gNextInstallation = 1;
+
+std::optional<std::string> optionalString(JNIEnv *env, jstring value) {
+  if (value == nullptr) {
+    return std::nullopt;
+  }
+  const char *chars = env->GetStringUTFChars(value, nullptr);
+  std::string result(chars);
+  env->ReleaseStringUTFChars(value, chars);
+  return result;
+}
+
+std::shared_ptr<AndroidPlatformBackend> backendFor(jlong installation) {
+  std::lock_guard<std::mutex> lock(gMutex);
+  auto it = gInstallations.find(installation);
+  return it == gInstallations.end() ? nullptr : it->second.backend;
+}
+
+// Forgets an invalidated installation once its last SDK call has answered.
+void releaseIfDone(jlong installation, const std::shared_ptr<AndroidPlatformBackend> &backend) {
+  if (!backend->isDone()) {
+    return;
+  }
+  std::shared_ptr<AndroidPlatformBackend> released; // destroyed outside gMutex
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    auto it = gInstallations.find(installation);
+    if (it != gInstallations.end() && it->second.backend == backend) {
+      released = std::move(it->second.backend);
+      gInstallations.erase(it);
+    }
+  }
+}
+
+// Answers payments of the stand-in environment instead of the SDK.
+std::shared_ptr<ScriptedPlatformBackend> gStandIn;
+
+std::shared_ptr<ScriptedPlatformBackend> standIn() {
+  std::lock_guard<std::mutex> lock(gMutex);
+  if (!gStandIn) {
+    gStandIn = std::make_shared<ScriptedPlatformBackend>();
+  }
+  return gStandIn;
+}
+
+} // namespace
+
+extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void *) {
+  return jni::initialize(vm, [] {});
+}
+
+// Returns the installation handle the other AppYarnPackageJSI entry points
+// take, 0 if nothing was installed.
+extern "C" JNIEXPORT jlong JNICALL Java_com_demoproject_AppYarnPackageJSI_nativeInstall(JNIEnv *, jobject thiz,
+                                                                                        jlong jsiRuntime,
+                                                                                        jobject callInvokerHolder) {
+  auto *runtime = reinterpret_cast<facebook::jsi::Runtime *>(jsiRuntime);
+  if (runtime == nullptr) {
+    return 0;
+  }
+  auto callInvoker =
+      jni::alias_ref<facebook::react::CallInvokerHolder::javaobject>{
+          reinterpret_cast<facebook::react::CallInvokerHolder::javaobject>(callInvokerHolder)}
+          ->cthis()
+          ->getCallInvoker();
+  auto backend = std::make_shared<AndroidPlatformBackend>(thiz);
+  auto bridge = std::make_shared<SPayBridge>(backend, PaymentScheduler::shared());
+  SPayHostObject::install(*runtime, bridge, callInvoker);
+  std::lock_guard<std::mutex> lock(gMutex);
+  jlong installation = gNextInstallation++;
+  gInstallations[installation] = {backend, bridge};
+  return installation;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_demoproject_AppYarnPackageJSI_nativeInvalidate(JNIEnv *, jobject,
+                                                                                          jlong installation) {
+  if (auto backend = backendFor(installation)) {
+    backend->detach();
+    releaseIfDone(installation, backend);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_demoproject_AppYarnPackageJSI_nativeReportReadiness(JNIEnv *, jobject,
+                                                                                               jlong installation,
+                                                                                               jboolean isReady) {
+  std::shared_ptr<SPayBridge> bridge;
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    auto it = gInstallations.find(installation);
+    if (it != gInstallations.end()) {
+      bridge = it->second.bridge.lock();
+    }
+  }
+  if (bridge) {
+    bridge->updateReadiness(isReady);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_demoproject_AppYarnPackageJSI_nativeOnSetupResult(JNIEnv *env, jobject,
+                                                                                             jlong installation,
+                                                                                             jlong id, jstring error) {
+  if (auto backend = backendFor(installation)) {
+    backend->onSetupResult(id, optionalString(env, error));
+    releaseIfDone(installation, backend);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_demoproject_AppYarnPackageJSI_nativeOnPaymentResult(JNIEnv *env, jobject,
+                                                                                               jlong installation,
+                                                                                               jlong id, jint state,
+                                                                                               jstring info) {
+  if (auto backend = backendFor(installation)) {
+    PaymentOutcome outcome;
+    outcome.state = static_cast<PaymentState>(state);
+    outcome.info = optionalString(env, info).value_or("");
+    outcome.category = categoryFor(outcome.state);
+    backend->onPaymentResult(id, outcome);
+    releaseIfDone(installation, backend);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_demoproject_LatencyHistograms_nativeRecord(JNIEnv *, jclass, jint operation,
+                                                                                     jint outcome, jlong micros) {
+  LatencyRecorder::shared().record(static_cast<Operation>(operation), static_cast<PaymentState>(outcome),
+                                   std::chrono::microseconds(micros));
+}
+
+extern "C" JNIEXPORT jstring JNICALL Java_com_demoproject_LatencyHistograms_nativeDrain(JNIEnv *env, jclass) {
+  return env->NewStringUTF(toJson(LatencyRecorder::shared().drain()).c_str());
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_demoproject_PaymentScheduler_nativeSubmit(JNIEnv *env, jclass, jstring id,
+                                                                                    jstring policy, jint priority,
+                                                                                    jobject job) {
+  // The scheduler starts, drops and releases jobs on whichever thread finishes the
+  // active one, e.g. a stand-in backend thread the JVM doesn't know.
+  std::shared_ptr<_jobject> owner(env->NewGlobalRef(job), [](jobject ref) {
+    jni::ThreadScope scope;
+    jni::Environment::current()->DeleteGlobalRef(ref);
+  });
+  PaymentScheduler::Job scheduled;
+  scheduled.id = optionalString(env, id).value_or("");
+  scheduled.priority = priority;
+  scheduled.start = [owner] {
+    jni::ThreadScope scope;
+    JNIEnv *env = jni::Environment::current();
+    jclass cls = env->GetObjectClass(owner.get());
+    env->CallVoidMethod(owner.get(), env->GetMethodID(cls, "start", "()V"));
+    env->DeleteLocalRef(cls);
+  };
+  scheduled.drop = [owner](DropReason reason) {
+    jni::ThreadScope scope;
+    JNIEnv *env = jni::Environment::current();
+    jclass cls = env->GetObjectClass(owner.get());
+    jstring message = env->NewStringUTF(describe(reason));
+    env->CallVoidMethod(owner.get(), env->GetMethodID(cls, "drop", "(ILjava/lang/String;)V"),
+                        static_cast<jint>(reason), message);
+    env->DeleteLocalRef(message);
+    env->DeleteLocalRef(cls);
+  };
+  PaymentScheduler::shared()->submit(schedulingPolicyFromString(optionalString(env, policy).value_or("")),
+                                     std::move(scheduled));
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_demoproject_PaymentScheduler_nativeFinish(JNIEnv *env, jclass, jstring id) {
+  PaymentScheduler::shared()->finish(optionalString(env, id).value_or(""));
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_com_demoproject_PaymentScheduler_nativeCancel(JNIEnv *env, jclass,
+                                                                                        jstring id) {
+  return PaymentScheduler::shared()->cancel(optionalString(env, id).value_or(""));
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_com_demoproject_PaymentScheduler_nativeRelease(JNIEnv *env, jclass,
+                                                                                         jstring id) {
+  return PaymentScheduler::shared()->release(optionalString(env, id).value_or(""));
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_demoproject_StandInBackend_nativeConfigure(
+    JNIEnv *, jclass, jlong minPayMicros, jlong maxPayMicros, jdouble errorRatio, jdouble cancelRatio,
+    jdouble waitingRatio, jlong waitingToFinalMicros, jlong seed) {
+  BackendScript script;
+  script.minPayLatency = std::chrono::microseconds(minPayMicros);
+  script.maxPayLatency = std::chrono::microseconds(maxPayMicros);
+  script.outcomes = {{PaymentState::Success, 1.0 - errorRatio - cancelRatio},
+                     {PaymentState::Error, errorRatio},
+                     {PaymentState::Cancel, cancelRatio}};
+  script.waitingFirstRatio = waitingRatio;
+  script.waitingToFinal = std::chrono::microseconds(waitingToFinalMicros);
+  script.seed = static_cast<uint64_t>(seed);
+  auto next = std::make_shared<ScriptedPlatformBackend>(script);
+  std::shared_ptr<ScriptedPlatformBackend> previous;
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    previous = std::exchange(gStandIn, next);
+  }
+  // Payments still pending with the previous script are answered now, so their
+  // sessions finish and release the scheduler. The previous stand-in joins its
+  // worker when released, outside the lock.
+  if (previous) {
+    previous->flush();
+    previous->drain();
+  }
+}
+
+// Results arrive on the stand-in's worker thread, which is attached to the VM
+// only for the duration of each call.
+extern "C" JNIEXPORT void JNICALL Java_com_demoproject_StandInBackend_nativePay(JNIEnv *env, jclass, jint method,
+                                                                               jstring bankInvoiceId,
+                                                                               jobject listener) {
+  std::shared_ptr<_jobject> owner(env->NewGlobalRef(listener), [](jobject ref) {
+    jni::ThreadScope scope;
+    jni::Environment::current()->DeleteGlobalRef(ref);
+  });
+  PaymentRequest request;
+  request.bankInvoiceId = optionalString(env, bankInvoiceId).value_or("");
+  standIn()->pay(static_cast<PayMethod>(method), request, [owner](const PaymentOutcome &outcome) {
+    jni::ThreadScope scope;
+    JNIEnv *env = jni::Environment::current();
+    jclass cls = env->GetObjectClass(owner.get());
+    jstring info = outcome.info.empty() ? nullptr : env->NewStringUTF(outcome.info.c_str());
+    env->CallVoidMethod(owner.get(), env->GetMethodID(cls, "onResult", "(ILjava/lang/String;)V"),
+                        static_cast<jint>(outcome.state), info);
+    if (info != nullptr) {
+      env->DeleteLocalRef(info);
+    }
+    env->DeleteLocalRef(cls);
+  });
+}
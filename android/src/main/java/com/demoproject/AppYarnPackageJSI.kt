@@ -0,0 +1,136 @@
+package com.demoproject
+
+import android.app.Application
+import com.facebook.proguard.annotations.DoNotStrip
+import com.facebook.react.bridge.ReactApplicationContext
+import com.facebook.react.turbomodule.core.CallInvokerHolderImpl
+
+import spay.sdk.api.PaymentResult
+
+/**
+ * Platform backend of the C++ payment bridge in `cpp/`. [install] exposes it to JS as
+ * `global.__SPayBridge`; the native side calls [setup], [isReady] and [pay] through JNI
+ * and receives results via the `nativeOn*Result` entry points.
+ *
+ * Each instance owns its own native bridge, scoped to the runtime it was installed into;
+ * [invalidate] releases it together with this instance and the React context.
+ */
+class AppYarnPackageJSI(private val reactContext: ReactApplicationContext) {
+
+  // The native installation, 0 until install() succeeds. Kept after invalidate() so SDK
+  // calls that were already running report to it.
+  @Volatile
+  private var handle = 0L
+
+  private val application: Application
+    get() = reactContext.applicationContext as Application
+
+  fun install(): Boolean {
+    if (handle != 0L) {
+      return true
+    }
+    val jsContext = reactContext.javaScriptContextHolder ?: return false
+    if (jsContext.get() == 0L) {
+      return false
+    }
+    if (!NativeLibrary.loaded) {
+      return false
+    }
+    @Suppress("DEPRECATION")
+    val callInvokerHolder = reactContext.catalystInstance.jsCallInvokerHolder as CallInvokerHolderImpl
+    handle = nativeInstall(jsContext.get(), callInvokerHolder)
+    return handle != 0L
+  }
+
+  fun reportReadiness(isReady: Boolean) {
+    val installation = handle
+    if (installation != 0L) {
+      nativeReportReadiness(installation, isReady)
+    }
+  }
+
+  /** Detaches the native bridge; SDK calls already running still report their results. */
+  fun invalidate() {
+    val installation = handle
+    if (installation != 0L) {
+      nativeInvalidate(installation)
+    }
+  }
+
+  @DoNotStrip
+  fun setup(
+    bnplPlan: Boolean,
+    resultViewNeeded: Boolean,
+    helpers: Boolean,
+    needLogs: Boolean,
+    sbp: Boolean,
+    creditCard: Boolean,
+    debitCard: Boolean,
+    environment: Int,
+    callbackId: Long
+  ) {
+    val installation = handle
+    val config = SPaySetup.Config(
+      bnplPlan, resultViewNeeded, helpers, needLogs, sbp, creditCard, debitCard, environment
+    )
+    SPaySetup.run(application, config) { error -> nativeOnSetupResult(installation, callbackId, error) }
+  }
+
+  @DoNotStrip
+  fun isReady(): Boolean {
+    return SPaySetup.isReady(application)
+  }
+
+  @DoNotStrip
+  fun pay(
+    method: Int,
+    merchantLogin: String,
+    bankInvoiceId: String,
+    orderNumber: String,
+    language: String,
+    redirectUri: String,
+    apiKey: String,
+    callbackId: Long
+  ) {
+    val installation = handle
+    if (SPaySetup.isStandIn) {
+      StandInBackend.pay(PayMethod.values()[method], bankInvoiceId) { state, info ->
+        nativeOnPaymentResult(installation, callbackId, state, info)
+      }
+      return
+    }
+    val activity = reactContext.currentActivity
+    if (activity == null) {
+      nativeOnPaymentResult(installation, callbackId, STATE_ERROR, "The activity is not initialized")
+      return
+    }
+    val onResult = { paymentResult: PaymentResult ->
+      when (paymentResult) {
+        is PaymentResult.Success -> nativeOnPaymentResult(installation, callbackId, STATE_SUCCESS, null)
+        is PaymentResult.Processing -> nativeOnPaymentResult(installation, callbackId, STATE_WAITING, null)
+        is PaymentResult.Cancel -> nativeOnPaymentResult(installation, callbackId, STATE_CANCEL, null)
+        is PaymentResult.Error -> nativeOnPaymentResult(installation, callbackId, STATE_ERROR, paymentResult.toString())
+      }
+    }
+    try {
+      val request = PaymentRequest(apiKey, merchantLogin, bankInvoiceId, orderNumber, language)
+      SPayPayments.pay(activity, PayMethod.values()[method], request, onResult)
+    } catch (e: Exception) {
+      nativeOnPaymentResult(installation, callbackId, STATE_ERROR, e.toString())
+    }
+  }
+
+  private external fun nativeInstall(jsiRuntime: Long, callInvokerHolder: CallInvokerHolderImpl): Long
+  private external fun nativeInvalidate(installation: Long)
+  private external fun nativeReportReadiness(installation: Long, isReady: Boolean)
+  private external fun nativeOnSetupResult(installation: Long, callbackId: Long, error: String?)
+  private external fun nativeOnPaymentResult(installation: Long, callbackId: Long, state: Int, info: String?)
+
+  companion object {
+    // Must match spaybridge::PaymentState in cpp/SPayBridge.h.
+    private const val STATE_SUCCESS = 0
+    private const val STATE_WAITING = 1
+    private const val STATE_CANCEL = 2
+    private const val STATE_ERROR = 3
+  }
+}
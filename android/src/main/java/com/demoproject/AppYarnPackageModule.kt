@@ -1,167 +1,317 @@
 package com.demoproject
 
+import android.app.Application
+import android.content.BroadcastReceiver
+import android.content.Context
+import android.content.Intent
+import android.content.IntentFilter
+import android.os.SystemClock
+import com.facebook.react.bridge.Arguments
 import com.facebook.react.bridge.ReactApplicationContext
-import com.facebook.react.bridge.ReactContextBaseJavaModule
 import com.facebook.react.bridge.ReactMethod
 import com.facebook.react.bridge.ReadableMap
 import com.facebook.react.bridge.Callback
+import com.facebook.react.bridge.UiThreadUtil
+import com.facebook.react.modules.core.DeviceEventManagerModule
 
-import spay.sdk.SPaySdkApp
-import spay.sdk.api.InitializationResult
-import spay.sdk.api.SPayStage
-import spay.sdk.api.SPayHelpers
-import spay.sdk.api.SPayHelperConfig
-import spay.sdk.SPaySdkInitConfig
-import spay.sdk.api.PaymentResult
+import java.util.UUID
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicReference
 
 class AppYarnPackageModule(reactContext: ReactApplicationContext) :
-  ReactContextBaseJavaModule(reactContext) {
+  AppYarnPackageSpec(reactContext) {
+
+  private val application: Application
+    get() = reactApplicationContext.applicationContext as Application
+
+  @Volatile
+  private var lastReadiness: Boolean? = null
+
+  private val jsi = AppYarnPackageJSI(reactContext)
+
+  // Payments that haven't answered JS yet, by session id.
+  private val pendingSessions = ConcurrentHashMap<String, PaymentSession>()
+
+  // Small app-private key/value store for state the JS side keeps across
+  // launches, such as cached payment tokens.
+  private val store by lazy {
+    reactApplicationContext.getSharedPreferences(STORE_NAME, Context.MODE_PRIVATE)
+  }
+
+  // Readiness depends on which bank apps are installed, so it is only re-read
+  // when a package is added, replaced or removed.
+  private val packageReceiver = object : BroadcastReceiver() {
+    override fun onReceive(context: Context, intent: Intent) {
+      refreshReadiness()
+    }
+  }
 
   override fun getName(): String {
     return NAME
   }
 
-  @ReactMethod
-  fun setupSDK(params: ReadableMap, callBack: Callback) {
-    val activity = currentActivity
-    val listOfHelpers = mutableListOf<SPayHelpers>()
-    val config = SPaySdkInitConfig(
-      activity?.application ?: throw IllegalArgumentException("The activity is not initialized"),
-      params.getBoolean("bnplPlan"),
-      SPayStage.Prod,
-      SPayHelperConfig(params.getBoolean("helpers"), listOfHelpers),
-      params.getBoolean("resultViewNeeded"),
-      params.getBoolean("needLogs")
-    ) { initializationResult ->
-      when (initializationResult) {
-        is InitializationResult.Success -> callBack.invoke()
-        is InitializationResult.ConfigError -> callBack.invoke(initializationResult.message)
-      }
+  override fun initialize() {
+    super.initialize()
+    val filter = IntentFilter().apply {
+      addAction(Intent.ACTION_PACKAGE_ADDED)
+      addAction(Intent.ACTION_PACKAGE_REPLACED)
+      addAction(Intent.ACTION_PACKAGE_REMOVED)
+      addDataScheme("package")
     }
-    SPaySdkApp.getInstance().initialize(config)
+    reactApplicationContext.registerReceiver(packageReceiver, filter)
+  }
+
+  override fun invalidate() {
+    reactApplicationContext.unregisterReceiver(packageReceiver)
+    jsi.invalidate()
+    super.invalidate()
+  }
+
+  @ReactMethod(isBlockingSynchronousMethod = true)
+  override fun installJSI(): Boolean {
+    return jsi.install()
+  }
+
+  @ReactMethod
+  override fun getStoredValue(key: String, callBack: Callback) {
+    callBack.invoke(store.getString(key, null))
   }
 
   @ReactMethod
-  fun isReadyForSPay(callBack: Callback) {
-    val activity = currentActivity
-    val result = SPaySdkApp.getInstance().isReadyForSPaySdk(
-      activity?.application ?: throw IllegalArgumentException("The activity is not initialized")
-    )
-    callBack.invoke(result)
+  override fun setStoredValue(key: String, value: String?) {
+    store.edit().apply {
+      if (value != null) putString(key, value) else remove(key)
+    }.apply()
   }
 
   @ReactMethod
-  fun payWithBankInvoiceId(requestParams: ReadableMap, callBack: Callback) {
-    val activity = currentActivity
-    try {
-      SPaySdkApp.getInstance().payWithBankInvoiceId(
-        activity ?: throw IllegalArgumentException("The activity is not initialized"),
-        requestParams.getString("apiKey").toString(),
-        requestParams.getString("merchantLogin"),
-        requestParams.getString("bankInvoiceId").toString(),
-        requestParams.getString("orderNumber").toString(),
-        "RU",
-        requestParams.getString("language")
-      ) { paymentResult ->
-        when (paymentResult) {
-          is PaymentResult.Success -> {
-            // do on success
-            callBack.invoke(null, "success")
-          }
-          is PaymentResult.Error -> {
-            // do on error
-            callBack.invoke("error", paymentResult.toString())
-          }
-          is PaymentResult.Processing -> {
-            // do on processing
-            callBack.invoke(null, "waiting")
-          }
-          // do on cancel
-          is PaymentResult.Cancel -> {
-            callBack.invoke(null, "cancel")
-          }
-        }
+  override fun addListener(eventName: String) {
+    // Required by NativeEventEmitter, events are emitted regardless of listeners.
+  }
+
+  @ReactMethod
+  override fun removeListeners(count: Double) {
+    // Required by NativeEventEmitter.
+  }
+
+  private fun refreshReadiness(): Boolean {
+    val isReady = SPaySetup.isReady(application)
+    if (lastReadiness != isReady) {
+      lastReadiness = isReady
+      jsi.reportReadiness(isReady)
+      val body = Arguments.createMap().apply { putBoolean("isReady", isReady) }
+      emit(READINESS_CHANGED_EVENT, body)
+    }
+    return isReady
+  }
+
+  // The SDK reports Processing and later the final result for the same payment,
+  // but a RN Callback may fire only once. Every transition is streamed to JS as
+  // an event, the callback only receives the first one together with the trace
+  // marks up to that point. The callback is dropped once it has fired, since
+  // the SDK may keep its result listener, and with it the session, for good.
+  private inner class PaymentSession(
+    private val method: PayMethod,
+    private val requestParams: ReadableMap,
+    private val trace: PaymentTrace,
+    callBack: Callback
+  ) : PaymentScheduler.Job {
+    val sessionId = if (requestParams.hasKey("sessionId")) {
+      requestParams.getString("sessionId") ?: UUID.randomUUID().toString()
+    } else {
+      UUID.randomUUID().toString()
+    }
+    private val callBack = AtomicReference<Callback?>(callBack)
+
+    override fun start() {
+      trace.mark("started")
+      val request = try {
+        PaymentRequest.from(requestParams)
+      } catch (e: Exception) {
+        finish(STATE_ERROR, CATEGORY_INTERNAL, e.toString())
+        return
+      }
+      SPayPayments.dispatch(
+        currentActivity,
+        method,
+        request,
+        onInvoked = { trace.mark("sdkInvoked") },
+        onState = this::finish
+      )
+    }
+
+    override fun drop(reason: Int, message: String) {
+      if (reason == PaymentScheduler.DROP_CANCELLED) {
+        finish(STATE_CANCEL, CATEGORY_NONE, null)
+      } else {
+        finish(STATE_ERROR, CATEGORY_SCHEDULING, message)
+      }
+    }
+
+    // JS receives (code, category, info, localSessionId, marks); the SDK's
+    // PaymentResult carries no session id of its own.
+    private fun finish(state: Int, category: Int, info: String?) {
+      val body = Arguments.createMap().apply {
+        putString("sessionId", sessionId)
+        putString("state", STATE_NAMES[state])
+        info?.let { putString("info", it) }
+      }
+      emit(PAYMENT_STATE_CHANGED_EVENT, body)
+      takeCallback()?.let { reply ->
+        trace.mark("completed")
+        LatencyHistograms.record(LatencyHistograms.operationFor(method), state, trace.startedAtNanos)
+        reply.invoke(state, category, info, null, trace.toWritableMap())
+      }
+      // The sheet is gone once the SDK reports anything, let the next payment in.
+      // This holds for abandoned sessions too; the scheduler ignores later calls.
+      PaymentScheduler.finish(sessionId)
+    }
+
+    // Answers JS with `code` without waiting for the SDK, whose late results
+    // are still emitted as events. A payment still waiting in the queue is
+    // dropped; the active one keeps its slot until the SDK reports a state,
+    // since its sheet may still be on screen, or for ABANDONED_SLOT_GRACE_MS
+    // at most.
+    fun abandon(code: Int) {
+      val reply = takeCallback() ?: return
+      reply.invoke(code, CATEGORY_NONE, null, null, trace.toWritableMap())
+      if (!PaymentScheduler.cancel(sessionId)) {
+        UiThreadUtil.runOnUiThread({ PaymentScheduler.release(sessionId) }, ABANDONED_SLOT_GRACE_MS)
       }
-    } catch (e: Exception) {
-      callBack.invoke("error exception", e.toString())
+    }
+
+    private fun takeCallback(): Callback? {
+      val reply = callBack.getAndSet(null) ?: return null
+      pendingSessions.remove(sessionId, this)
+      return reply
     }
   }
 
+  private fun emit(eventName: String, body: Any?) {
+    if (!reactApplicationContext.hasActiveReactInstance()) {
+      return
+    }
+    reactApplicationContext
+      .getJSModule(DeviceEventManagerModule.RCTDeviceEventEmitter::class.java)
+      .emit(eventName, body)
+  }
+
+  // Joins an init started by SPaySetup.preinitialize before the bundle loaded
+  // when the config matches; the activity isn't needed for either.
   @ReactMethod
-  fun payWithPartPay(requestParams: ReadableMap, callBack: Callback) {
-    val activity = currentActivity
-    try {
-      SPaySdkApp.getInstance().payWithPartPay(
-        activity ?: throw IllegalArgumentException("The activity is not initialized"),
-        requestParams.getString("apiKey").toString(),
-        requestParams.getString("merchantLogin"),
-        requestParams.getString("bankInvoiceId").toString(),
-        requestParams.getString("orderNumber").toString(),
-        "RU",
-        requestParams.getString("language")
-      ) { paymentResult ->
-        when (paymentResult) {
-          is PaymentResult.Success -> {
-            // do on success
-            callBack.invoke(null, "success")
-          }
-          is PaymentResult.Error -> {
-            // do on error
-            callBack.invoke("error", paymentResult.toString())
-          }
-          is PaymentResult.Processing -> {
-            // do on processing
-            callBack.invoke(null, "waiting")
-          }
-          // do on cancel
-          is PaymentResult.Cancel -> {
-            callBack.invoke(null, "cancel")
-          }
-        }
+  override fun setupSDK(params: ReadableMap, environment: Double, callBack: Callback) {
+    val startedAt = SystemClock.elapsedRealtimeNanos()
+    val config = SPaySetup.Config.from(params, environment.toInt())
+    if (params.hasKey("warmUpHosts")) {
+      params.getArray("warmUpHosts")?.toArrayList()?.filterIsInstance<String>()?.let {
+        SPayNetwork.warmUp(it)
+      }
+    }
+    SPaySetup.run(application, config) { error ->
+      if (error == null) {
+        LatencyHistograms.record(LatencyHistograms.OP_SETUP, LatencyHistograms.OUTCOME_SUCCESS, startedAt)
+        callBack.invoke()
+        refreshReadiness()
+      } else {
+        LatencyHistograms.record(LatencyHistograms.OP_SETUP, LatencyHistograms.OUTCOME_ERROR, startedAt)
+        callBack.invoke(error)
       }
-    } catch (e: Exception) {
-      callBack.invoke("error exception", e.toString())
     }
   }
 
+  // Everything startup needs in one round trip instead of separate setup,
+  // readiness and config queries.
   @ReactMethod
-  fun payWithoutRefresh(requestParams: ReadableMap, callBack: Callback) {
-    val activity = currentActivity
-    try {
-      SPaySdkApp.getInstance().payWithoutRefresh(
-        activity ?: throw IllegalArgumentException("The activity is not initialized"),
-        requestParams.getString("apiKey").toString(),
-        requestParams.getString("merchantLogin"),
-        requestParams.getString("bankInvoiceId").toString(),
-        requestParams.getString("orderNumber").toString(),
-        "RU",
-        requestParams.getString("language")
-      ) { paymentResult ->
-        when (paymentResult) {
-          is PaymentResult.Success -> {
-            // do on success
-            callBack.invoke(null, "success")
-          }
-          is PaymentResult.Error -> {
-            // do on error
-            callBack.invoke("error", paymentResult.toString())
-          }
-          is PaymentResult.Processing -> {
-            // do on processing
-            callBack.invoke(null, "waiting")
-          }
-          // do on cancel
-          is PaymentResult.Cancel -> {
-            callBack.invoke(null, "cancel")
-          }
-        }
+  override fun getStatus(callBack: Callback) {
+    val setup = SPaySetup.snapshot()
+    val status = Arguments.createMap().apply {
+      putString("initState", setup?.state ?: SETUP_IDLE)
+      setup?.error?.let { putString("initError", it) }
+      putBoolean("isReady", refreshReadiness())
+      if (setup != null) {
+        putInt("environment", setup.config.environment)
+        putMap("config", Arguments.createMap().apply {
+          setup.config.flags().forEach { (flag, enabled) -> putBoolean(flag, enabled) }
+        })
       }
-    } catch (e: Exception) {
-      callBack.invoke("error exception", e.toString())
+      putString("sdkVersion", BuildConfig.SPAY_SDK_VERSION)
+      putString("fingerprint", SPayFingerprint.state)
     }
+    callBack.invoke(status)
+  }
+
+  @ReactMethod
+  override fun isReadyForSPay(callBack: Callback) {
+    val startedAt = SystemClock.elapsedRealtimeNanos()
+    val isReady = refreshReadiness()
+    LatencyHistograms.record(LatencyHistograms.OP_IS_READY, LatencyHistograms.OUTCOME_SUCCESS, startedAt)
+    callBack.invoke(isReady)
+  }
+
+  @ReactMethod
+  override fun drainLatencyHistograms(callBack: Callback) {
+    callBack.invoke(LatencyHistograms.drain())
+  }
+
+  @ReactMethod
+  override fun payWithBankInvoiceId(requestParams: ReadableMap, callBack: Callback) {
+    pay(PayMethod.BANK_INVOICE_ID, requestParams, callBack)
+  }
+
+  @ReactMethod
+  override fun payWithPartPay(requestParams: ReadableMap, callBack: Callback) {
+    pay(PayMethod.PART_PAY, requestParams, callBack)
+  }
+
+  @ReactMethod
+  override fun payWithoutRefresh(requestParams: ReadableMap, callBack: Callback) {
+    pay(PayMethod.WITHOUT_REFRESH, requestParams, callBack)
+  }
+
+  // Only one SDK sheet can be on screen, so payments go through the process-wide
+  // scheduler and start once the previous sheet has reported its first state.
+  private fun pay(method: PayMethod, requestParams: ReadableMap, callBack: Callback) {
+    val session = PaymentSession(method, requestParams, PaymentTrace(), callBack)
+    pendingSessions[session.sessionId] = session
+    val policy = if (requestParams.hasKey("policy")) requestParams.getString("policy") else null
+    val priority = if (requestParams.hasKey("priority")) requestParams.getDouble("priority").toInt() else 0
+    PaymentScheduler.submit(session.sessionId, policy, priority, session)
+  }
+
+  @ReactMethod
+  override fun cancelPayment(sessionId: String, callBack: Callback) {
+    callBack.invoke(PaymentScheduler.cancel(sessionId))
+  }
+
+  @ReactMethod
+  override fun abandonPayment(sessionId: String, code: Double) {
+    pendingSessions[sessionId]?.abandon(code.toInt())
   }
 
   companion object {
     const val NAME = "AppYarnPackage"
+    const val STORE_NAME = "com.demoproject.AppYarnPackage"
+    const val READINESS_CHANGED_EVENT = "AppYarnPackageReadinessChanged"
+    const val PAYMENT_STATE_CHANGED_EVENT = "AppYarnPackagePaymentStateChanged"
+
+    private const val SETUP_IDLE = "idle"
+
+    // How long an abandoned payment's sheet may keep the scheduler slot
+    // before the next payment is let through anyway.
+    private const val ABANDONED_SLOT_GRACE_MS = 60_000L
+
+    // Must match spaybridge::PaymentState and spaybridge::ErrorCategory in
+    // cpp/SPayBridge.h.
+    const val STATE_SUCCESS = 0
+    const val STATE_WAITING = 1
+    const val STATE_CANCEL = 2
+    const val STATE_ERROR = 3
+    val STATE_NAMES = arrayOf("success", "waiting", "cancel", "error")
+
+    const val CATEGORY_NONE = 0
+    const val CATEGORY_SDK = 1
+    const val CATEGORY_PRESENTATION = 2
+    const val CATEGORY_SCHEDULING = 3
+    const val CATEGORY_INTERNAL = 4
   }
 }
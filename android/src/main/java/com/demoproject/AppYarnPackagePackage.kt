@@ -1,14 +1,37 @@
 package com.demoproject
 
-import com.facebook.react.ReactPackage
+import com.facebook.react.TurboReactPackage
 import com.facebook.react.bridge.NativeModule
 import com.facebook.react.bridge.ReactApplicationContext
+import com.facebook.react.module.model.ReactModuleInfo
+import com.facebook.react.module.model.ReactModuleInfoProvider
 import com.facebook.react.uimanager.ViewManager
 
 
-class AppYarnPackagePackage : ReactPackage {
-  override fun createNativeModules(reactContext: ReactApplicationContext): List<NativeModule> {
-    return listOf(AppYarnPackageModule(reactContext))
+class AppYarnPackagePackage : TurboReactPackage() {
+  override fun getModule(name: String, reactContext: ReactApplicationContext): NativeModule? {
+    return if (name == AppYarnPackageModule.NAME) {
+      AppYarnPackageModule(reactContext)
+    } else {
+      null
+    }
+  }
+
+  // Modules are created on first access from JS instead of eagerly at startup.
+  override fun getReactModuleInfoProvider(): ReactModuleInfoProvider {
+    return ReactModuleInfoProvider {
+      mapOf(
+        AppYarnPackageModule.NAME to ReactModuleInfo(
+          AppYarnPackageModule.NAME,
+          AppYarnPackageModule::class.java.name,
+          false, // canOverrideExistingModule
+          false, // needsEagerInit
+          false, // hasConstants
+          false, // isCxxModule
+          BuildConfig.IS_NEW_ARCHITECTURE_ENABLED // isTurboModule
+        )
+      )
+    }
   }
 
   override fun createViewManagers(reactContext: ReactApplicationContext): List<ViewManager<*, *>> {
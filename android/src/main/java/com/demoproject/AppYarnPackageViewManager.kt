@@ -1,15 +1,144 @@
 package com.demoproject
 
-import android.view.View
-import com.facebook.react.uimanager.SimpleViewManager
+import android.graphics.drawable.Drawable
+import com.facebook.react.bridge.ReadableMap
+import com.facebook.react.bridge.UiThreadUtil
+import com.facebook.react.module.annotations.ReactModule
 import com.facebook.react.uimanager.ThemedReactContext
+import com.facebook.react.uimanager.UIManagerHelper
+import com.facebook.react.uimanager.annotations.ReactProp
+import java.util.UUID
+import java.util.WeakHashMap
 
 import spay.sdk.view.SPayButton
 
-class AppYarnPackageViewManager : SimpleViewManager<View>() {
-  override fun getName() = "AppYarnPackageView"
+@ReactModule(name = AppYarnPackageViewManager.NAME)
+class AppYarnPackageViewManager : AppYarnPackageViewManagerSpec<SPayButton>() {
+
+  // `color` null means the SDK button's own background, kept in `defaultBackground`.
+  private class ButtonState(val defaultBackground: Drawable.ConstantState?) {
+    var color: Int? = null
+    var request: PaymentRequest? = null
+    var method = PayMethod.BANK_INVOICE_ID
+    var paymentInFlight = false
+  }
+
+  // Per-button props, so unchanged props don't touch the view and a tap can
+  // start the payment without asking JS for the request.
+  private val states = WeakHashMap<SPayButton, ButtonState>()
+
+  init {
+    // Unmounted buttons go back to a pool and are reused by the next mount
+    // instead of inflating a new SDK button for every list cell.
+    setupViewRecycling()
+  }
+
+  override fun getName() = NAME
 
   override fun createViewInstance(reactContext: ThemedReactContext): SPayButton {
-    return SPayButton(reactContext, null)
+    val button = SPayButton(reactContext, null)
+    button.setOnClickListener { startPayment(reactContext, button) }
+    return button
+  }
+
+  override fun prepareToRecycleView(reactContext: ThemedReactContext, view: SPayButton): SPayButton? {
+    super.prepareToRecycleView(reactContext, view)
+    applyColor(view, null)
+    // A payment still in flight keeps the old state and reports to the old tag, so
+    // the next mount neither inherits paymentInFlight nor receives its result.
+    states[view] = ButtonState(stateOf(view).defaultBackground)
+    return view
+  }
+
+  override fun getExportedCustomDirectEventTypeConstants(): Map<String, Any> {
+    return mapOf(PaymentResultEvent.EVENT_NAME to mapOf("registrationName" to "onPaymentResult"))
+  }
+
+  @ReactProp(name = "color", customType = "Color")
+  override fun setColor(view: SPayButton, color: Int?) {
+    applyColor(view, color)
+  }
+
+  @ReactProp(name = "paymentRequest")
+  override fun setPaymentRequest(view: SPayButton, value: ReadableMap?) {
+    stateOf(view).request = value?.let { PaymentRequest.from(it) }
+  }
+
+  @ReactProp(name = "payMethod")
+  override fun setPayMethod(view: SPayButton, value: String?) {
+    stateOf(view).method = PayMethod.fromName(value)
+  }
+
+  // The first lookup happens before any color prop, so it still sees the SDK's
+  // background. It is copied, since setBackgroundColor may change a ColorDrawable in place.
+  private fun stateOf(view: SPayButton) = states.getOrPut(view) {
+    ButtonState(view.background?.constantState?.newDrawable()?.mutate()?.constantState)
+  }
+
+  private fun applyColor(view: SPayButton, color: Int?) {
+    val state = stateOf(view)
+    if (state.color == color) {
+      return
+    }
+    state.color = color
+    if (color != null) {
+      view.setBackgroundColor(color)
+    } else {
+      view.background = state.defaultBackground?.newDrawable()?.mutate()
+    }
+  }
+
+  // Goes through the same process-wide scheduler as the module's pay calls, so a tap
+  // never opens a second SDK sheet over one that is still on screen.
+  private fun startPayment(reactContext: ThemedReactContext, view: SPayButton) {
+    val state = stateOf(view)
+    val request = state.request ?: return
+    if (state.paymentInFlight) {
+      return
+    }
+    state.paymentInFlight = true
+    val payment = ButtonPayment(reactContext, view, state, request)
+    PaymentScheduler.submit(payment.sessionId, null, 0, payment)
+  }
+
+  // Captures the mount it was started from: the view may be recycled for another
+  // one before the SDK reports.
+  private inner class ButtonPayment(
+    private val reactContext: ThemedReactContext,
+    view: SPayButton,
+    private val state: ButtonState,
+    private val request: PaymentRequest
+  ) : PaymentScheduler.Job {
+    val sessionId = "button-${UUID.randomUUID()}"
+    private val method = state.method
+    private val reactTag = view.id
+    private val surfaceId = UIManagerHelper.getSurfaceId(view)
+
+    // Same dispatch as the module's pay calls, so stand-in mode answers taps too.
+    override fun start() {
+      SPayPayments.dispatch(reactContext.currentActivity, method, request) { paymentState, _, info ->
+        finish(AppYarnPackageModule.STATE_NAMES[paymentState], info)
+      }
+    }
+
+    override fun drop(reason: Int, message: String) {
+      // Never started, the scheduler ignores finish() for it.
+      finish(if (reason == PaymentScheduler.DROP_CANCELLED) "cancel" else "error", message)
+    }
+
+    private fun finish(paymentState: String, info: String?) {
+      UiThreadUtil.runOnUiThread {
+        // Processing closes the sheet as well, the button takes taps again.
+        state.paymentInFlight = false
+        val dispatcher = UIManagerHelper.getEventDispatcherForReactTag(reactContext, reactTag)
+        dispatcher?.dispatchEvent(PaymentResultEvent(surfaceId, reactTag, paymentState, info))
+      }
+      // The sheet is gone once the SDK reports anything, let the next payment in.
+      PaymentScheduler.finish(sessionId)
+    }
+  }
+
+  companion object {
+    const val NAME = "AppYarnPackageView"
   }
 }
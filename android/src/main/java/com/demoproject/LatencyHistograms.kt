@@ -0,0 +1,35 @@
+package com.demoproject
+
+import android.os.SystemClock
+
+/**
+ * Latency histograms kept by the C++ core (`cpp/LatencyHistogram.h`), so both
+ * platforms bucket and summarise identically in fixed memory.
+ */
+internal object LatencyHistograms {
+  // Must match spaybridge::Operation in cpp/LatencyHistogram.h.
+  const val OP_SETUP = 0
+  const val OP_IS_READY = 1
+  private const val OP_PAY_BANK_INVOICE_ID = 2
+
+  // Outcomes are spaybridge::PaymentState values, see AppYarnPackageModule.STATE_*.
+  const val OUTCOME_SUCCESS = AppYarnPackageModule.STATE_SUCCESS
+  const val OUTCOME_ERROR = AppYarnPackageModule.STATE_ERROR
+
+  fun operationFor(method: PayMethod) = OP_PAY_BANK_INVOICE_ID + method.ordinal
+
+  fun record(operation: Int, outcome: Int, startedAtNanos: Long) {
+    if (NativeLibrary.loaded) {
+      nativeRecord(operation, outcome, (SystemClock.elapsedRealtimeNanos() - startedAtNanos) / 1000)
+    }
+  }
+
+  /** JSON array of the non-empty histograms' summaries; the histograms are reset. */
+  fun drain(): String = if (NativeLibrary.loaded) nativeDrain() else "[]"
+
+  @JvmStatic
+  private external fun nativeRecord(operation: Int, outcome: Int, micros: Long)
+
+  @JvmStatic
+  private external fun nativeDrain(): String
+}
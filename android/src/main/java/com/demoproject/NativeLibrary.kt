@@ -0,0 +1,10 @@
+package com.demoproject
+
+/** Loads the C++ core (`cpp/`) once for everything that calls into it over JNI. */
+internal object NativeLibrary {
+  const val NAME = "appyarnpackage"
+
+  val loaded by lazy {
+    runCatching { System.loadLibrary(NAME) }.isSuccess
+  }
+}
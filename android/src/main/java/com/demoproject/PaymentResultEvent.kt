@@ -0,0 +1,29 @@
+package com.demoproject
+
+import com.facebook.react.bridge.Arguments
+import com.facebook.react.bridge.WritableMap
+import com.facebook.react.uimanager.events.Event
+
+/** Direct event delivered to the button's `onPaymentResult` prop. */
+internal class PaymentResultEvent(
+  surfaceId: Int,
+  viewId: Int,
+  private val state: String,
+  private val info: String?
+) : Event<PaymentResultEvent>(surfaceId, viewId) {
+
+  override fun getEventName() = EVENT_NAME
+
+  // Waiting and the final state of one tap must both be delivered.
+  override fun canCoalesce() = false
+
+  override fun getEventData(): WritableMap = Arguments.createMap().apply {
+    putString("state", state)
+    putString("info", info ?: "")
+    putString("localSessionId", "")
+  }
+
+  companion object {
+    const val EVENT_NAME = "topPaymentResult"
+  }
+}
@@ -0,0 +1,54 @@
+package com.demoproject
+
+import com.facebook.proguard.annotations.DoNotStrip
+
+/**
+ * Process-wide payment queue kept by the C++ core (`cpp/PaymentScheduler.h`), shared
+ * with the JSI bridge, so only one SDK sheet is on screen at a time.
+ */
+internal object PaymentScheduler {
+  // Must match spaybridge::DropReason in cpp/PaymentScheduler.h.
+  const val DROP_CANCELLED = 0
+
+  @DoNotStrip
+  interface Job {
+    @DoNotStrip
+    fun start()
+
+    @DoNotStrip
+    fun drop(reason: Int, message: String)
+  }
+
+  /** `policy` is "enqueue" (default), "reject" or "replace". */
+  fun submit(id: String, policy: String?, priority: Int, job: Job) {
+    if (NativeLibrary.loaded) {
+      nativeSubmit(id, policy ?: "enqueue", priority, job)
+    } else {
+      job.start()
+    }
+  }
+
+  /** Marks the sheet of payment `id` as closed and starts the next one. */
+  fun finish(id: String) {
+    if (NativeLibrary.loaded) {
+      nativeFinish(id)
+    }
+  }
+
+  fun cancel(id: String): Boolean = NativeLibrary.loaded && nativeCancel(id)
+
+  /** Frees the slot of payment `id` even if its sheet never reports back, or cancels it. */
+  fun release(id: String): Boolean = NativeLibrary.loaded && nativeRelease(id)
+
+  @JvmStatic
+  private external fun nativeSubmit(id: String, policy: String, priority: Int, job: Job)
+
+  @JvmStatic
+  private external fun nativeFinish(id: String)
+
+  @JvmStatic
+  private external fun nativeCancel(id: String): Boolean
+
+  @JvmStatic
+  private external fun nativeRelease(id: String): Boolean
+}
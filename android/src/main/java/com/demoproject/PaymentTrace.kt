@@ -0,0 +1,28 @@
+package com.demoproject
+
+import android.os.SystemClock
+import com.facebook.react.bridge.Arguments
+import com.facebook.react.bridge.WritableMap
+
+/**
+ * Monotonic timestamps of the native stages of one payment call, in
+ * milliseconds since the call reached the module.
+ */
+internal class PaymentTrace {
+  val startedAtNanos = SystemClock.elapsedRealtimeNanos()
+  private val marks = LinkedHashMap<String, Double>()
+
+  init {
+    mark("received")
+  }
+
+  @Synchronized
+  fun mark(stage: String) {
+    marks[stage] = (SystemClock.elapsedRealtimeNanos() - startedAtNanos) / 1_000_000.0
+  }
+
+  @Synchronized
+  fun toWritableMap(): WritableMap = Arguments.createMap().apply {
+    marks.forEach { (stage, offset) -> putDouble(stage, offset) }
+  }
+}
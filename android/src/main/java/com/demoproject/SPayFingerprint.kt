@@ -0,0 +1,52 @@
+package com.demoproject
+
+import zone.bi.mobile.fingerprint.api.GpsCachingPeriod
+import zone.bi.mobile.fingerprint.api.ParameterType
+
+/**
+ * Loads the fingerprint library in the background once the SDK is set up, so the first
+ * payment doesn't pay for it between the tap and the sheet.
+ *
+ * The SDK collects the fingerprint itself and takes no report from outside, so only the
+ * process-wide part of the work is done here: loading `libbms_fp.so` and initialising the
+ * library's classes. A report collected here could not be used and is not collected.
+ */
+object SPayFingerprint {
+  const val STATE_IDLE = "idle"
+  const val STATE_PENDING = "pending"
+  const val STATE_READY = "ready"
+  const val STATE_FAILED = "failed"
+
+  private const val LIBRARY = "bms_fp"
+
+  @Volatile
+  var state = STATE_IDLE
+    private set
+
+  /** Starts the prefetch unless it has run or is running; returns without waiting. */
+  @JvmStatic
+  fun prefetch() {
+    synchronized(this) {
+      if (state == STATE_PENDING || state == STATE_READY) {
+        return
+      }
+      state = STATE_PENDING
+    }
+    Thread({
+      state = try {
+        System.loadLibrary(LIBRARY)
+        // Enum initialisation pulls in most of the obfuscated implementation classes.
+        ParameterType.values()
+        GpsCachingPeriod.values()
+        STATE_READY
+      } catch (e: LinkageError) {
+        // The SDK's own load will fail the same way and report it.
+        STATE_FAILED
+      }
+    }, "SPayFingerprintPrefetch").apply {
+      isDaemon = true
+      priority = Thread.MIN_PRIORITY
+      start()
+    }
+  }
+}
@@ -0,0 +1,34 @@
+package com.demoproject
+
+import java.net.InetAddress
+import java.net.UnknownHostException
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.Executors
+
+/**
+ * The DNS warm-up run by `setupSDK` when JS passes `warmUpHosts`. The SDK builds its own
+ * HTTP client, so no connection made here could be reused by it; resolving the hosts
+ * early still saves its first payment the lookup, since the system resolver caches it.
+ * Nothing is sent to the hosts.
+ */
+object SPayNetwork {
+  private val executor: ExecutorService = Executors.newCachedThreadPool { runnable ->
+    Thread(runnable, "SPayNetworkWarmUp").apply { isDaemon = true }
+  }
+
+  /** Resolves each host in the background. Failures are ignored; this only ever saves time. */
+  @JvmStatic
+  fun warmUp(hosts: Collection<String>) {
+    hosts.distinct().forEach { host -> executor.execute { resolve(host) } }
+  }
+
+  private fun resolve(host: String) {
+    try {
+      InetAddress.getAllByName(host)
+    } catch (e: UnknownHostException) {
+      // Unreachable for now; the SDK will find out on its own.
+    } catch (e: SecurityException) {
+      // The host app lacks the INTERNET permission.
+    }
+  }
+}
@@ -0,0 +1,123 @@
+package com.demoproject
+
+import android.app.Activity
+import com.facebook.react.bridge.ReadableMap
+
+import com.demoproject.AppYarnPackageModule.Companion.CATEGORY_INTERNAL
+import com.demoproject.AppYarnPackageModule.Companion.CATEGORY_NONE
+import com.demoproject.AppYarnPackageModule.Companion.CATEGORY_PRESENTATION
+import com.demoproject.AppYarnPackageModule.Companion.CATEGORY_SDK
+import com.demoproject.AppYarnPackageModule.Companion.STATE_CANCEL
+import com.demoproject.AppYarnPackageModule.Companion.STATE_ERROR
+import com.demoproject.AppYarnPackageModule.Companion.STATE_SUCCESS
+import com.demoproject.AppYarnPackageModule.Companion.STATE_WAITING
+
+import spay.sdk.SPaySdkApp
+import spay.sdk.api.PaymentResult
+
+/** The SDK's three bankInvoiceId based payment flows. Ordinals match spaybridge::PayMethod. */
+internal enum class PayMethod {
+  BANK_INVOICE_ID,
+  WITHOUT_REFRESH,
+  PART_PAY;
+
+  companion object {
+    fun fromName(name: String?): PayMethod = when (name) {
+      "withoutRefresh" -> WITHOUT_REFRESH
+      "partPay" -> PART_PAY
+      else -> BANK_INVOICE_ID
+    }
+  }
+}
+
+internal data class PaymentRequest(
+  val apiKey: String,
+  val merchantLogin: String?,
+  val bankInvoiceId: String,
+  val orderNumber: String,
+  val language: String?
+) {
+  companion object {
+    fun from(params: ReadableMap) = PaymentRequest(
+      params.getString("apiKey").toString(),
+      params.getString("merchantLogin"),
+      params.getString("bankInvoiceId").toString(),
+      params.getString("orderNumber").toString(),
+      params.getString("language")
+    )
+  }
+}
+
+internal object SPayPayments {
+  /**
+   * Starts a payment the way every entry point does: through the stand-in backend
+   * when SPaySetup.isStandIn, otherwise through the SDK from `activity`. Each state
+   * is reported as (STATE_*, CATEGORY_*, info); `onInvoked` runs once the request
+   * has been handed over.
+   */
+  fun dispatch(
+    activity: Activity?,
+    method: PayMethod,
+    request: PaymentRequest,
+    onInvoked: () -> Unit = {},
+    onState: (state: Int, category: Int, info: String?) -> Unit
+  ) {
+    try {
+      if (SPaySetup.isStandIn) {
+        onInvoked()
+        StandInBackend.pay(method, request.bankInvoiceId) { state, info ->
+          onState(state, if (state == STATE_ERROR) CATEGORY_SDK else CATEGORY_NONE, info)
+        }
+        return
+      }
+      if (activity == null) {
+        onState(STATE_ERROR, CATEGORY_PRESENTATION, "The activity is not initialized")
+        return
+      }
+      onInvoked()
+      pay(activity, method, request) { paymentResult ->
+        when (paymentResult) {
+          is PaymentResult.Success -> onState(STATE_SUCCESS, CATEGORY_NONE, null)
+          is PaymentResult.Error -> onState(STATE_ERROR, CATEGORY_SDK, paymentResult.toString())
+          is PaymentResult.Processing -> onState(STATE_WAITING, CATEGORY_NONE, null)
+          is PaymentResult.Cancel -> onState(STATE_CANCEL, CATEGORY_NONE, null)
+        }
+      }
+    } catch (e: Exception) {
+      onState(STATE_ERROR, CATEGORY_INTERNAL, e.toString())
+    }
+  }
+
+  fun pay(activity: Activity, method: PayMethod, request: PaymentRequest, onResult: (PaymentResult) -> Unit) {
+    val sdk = SPaySdkApp.getInstance()
+    when (method) {
+      PayMethod.BANK_INVOICE_ID -> sdk.payWithBankInvoiceId(
+        activity,
+        request.apiKey,
+        request.merchantLogin,
+        request.bankInvoiceId,
+        request.orderNumber,
+        "RU",
+        request.language
+      ) { paymentResult -> onResult(paymentResult) }
+      PayMethod.WITHOUT_REFRESH -> sdk.payWithoutRefresh(
+        activity,
+        request.apiKey,
+        request.merchantLogin,
+        request.bankInvoiceId,
+        request.orderNumber,
+        "RU",
+        request.language
+      ) { paymentResult -> onResult(paymentResult) }
+      PayMethod.PART_PAY -> sdk.payWithPartPay(
+        activity,
+        request.apiKey,
+        request.merchantLogin,
+        request.bankInvoiceId,
+        request.orderNumber,
+        "RU",
+        request.language
+      ) { paymentResult -> onResult(paymentResult) }
+    }
+  }
+}
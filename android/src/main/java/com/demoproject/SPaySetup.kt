@@ -0,0 +1,209 @@
+package com.demoproject
+
+import android.app.Application
+import android.content.Context
+import com.facebook.react.bridge.ReadableMap
+import org.json.JSONObject
+
+import spay.sdk.SPaySdkApp
+import spay.sdk.SPaySdkInitConfig
+import spay.sdk.api.InitializationResult
+import spay.sdk.api.SPayHelperConfig
+import spay.sdk.api.SPayHelpers
+import spay.sdk.api.SPayStage
+
+/**
+ * Single owner of SDK initialisation for the module, the JSI bridge and [preinitialize].
+ * A config that is being or has been initialised successfully is joined instead of
+ * initialising the SDK again, so a `setupSDK` call from JS attaches to an init started
+ * from `Application.onCreate` before the bundle loaded.
+ */
+object SPaySetup {
+  const val STATE_PENDING = "pending"
+  const val STATE_READY = "ready"
+  const val STATE_FAILED = "failed"
+
+  // Must match SDKEnvironment in src/index.tsx and spaybridge::Environment.
+  const val ENVIRONMENT_PROD = 0
+  const val ENVIRONMENT_SANDBOX_WITHOUT_BANK_APP = 1
+  const val ENVIRONMENT_SANDBOX_REAL_BANK_APP = 2
+  const val ENVIRONMENT_STAND_IN = 3
+
+  private const val PREFS_NAME = "com.demoproject.AppYarnPackage.setup"
+  private const val CONFIG_KEY = "config"
+
+  data class Config(
+    val bnplPlan: Boolean,
+    val resultViewNeeded: Boolean,
+    val helpers: Boolean,
+    val needLogs: Boolean,
+    val sbp: Boolean,
+    val creditCard: Boolean,
+    val debitCard: Boolean,
+    val environment: Int
+  ) {
+    // The SPaySetupParams flags by name.
+    fun flags(): Map<String, Boolean> = mapOf(
+      "bnplPlan" to bnplPlan,
+      "resultViewNeeded" to resultViewNeeded,
+      "helpers" to helpers,
+      "needLogs" to needLogs,
+      "sbp" to sbp,
+      "creditCard" to creditCard,
+      "debitCard" to debitCard
+    )
+
+    fun toJson(): String = JSONObject(flags()).put("environment", environment).toString()
+
+    companion object {
+      fun from(params: ReadableMap, environment: Int): Config {
+        fun flag(name: String) = params.hasKey(name) && params.getBoolean(name)
+        return Config(
+          flag("bnplPlan"), flag("resultViewNeeded"), flag("helpers"), flag("needLogs"),
+          flag("sbp"), flag("creditCard"), flag("debitCard"), environment
+        )
+      }
+
+      fun fromJson(json: String): Config? = try {
+        val obj = JSONObject(json)
+        Config(
+          obj.optBoolean("bnplPlan"), obj.optBoolean("resultViewNeeded"), obj.optBoolean("helpers"),
+          obj.optBoolean("needLogs"), obj.optBoolean("sbp"), obj.optBoolean("creditCard"),
+          obj.optBoolean("debitCard"), obj.optInt("environment")
+        )
+      } catch (e: Exception) {
+        null
+      }
+    }
+  }
+
+  class Snapshot(val config: Config, val state: String, val error: String?)
+
+  private class Init(val config: Config) {
+    var state = STATE_PENDING
+    var error: String? = null
+    val waiters = mutableListOf<(String?) -> Unit>()
+  }
+
+  // The latest init; guarded by this.
+  private var current: Init? = null
+
+  /**
+   * Starts initialising the SDK with [config], or with the config of the last successful
+   * `setupSDK` call when none is given. Call it from `Application.onCreate`; it returns
+   * without waiting and `false` when there is nothing to initialise with.
+   */
+  @JvmStatic
+  @JvmOverloads
+  fun preinitialize(context: Context, config: Config? = null): Boolean {
+    val application = context.applicationContext as Application
+    val resolved = config ?: load(application) ?: return false
+    run(application, resolved, null)
+    return true
+  }
+
+  /** Initialises the SDK with [config] or joins the init already running or done with it. */
+  fun run(application: Application, config: Config, callback: ((error: String?) -> Unit)?) {
+    var replay = false
+    val init = synchronized(this) {
+      val existing = current
+      if (existing != null && existing.config == config && existing.state != STATE_FAILED) {
+        if (existing.state == STATE_PENDING) {
+          callback?.let { existing.waiters.add(it) }
+        } else {
+          replay = true
+        }
+        null
+      } else {
+        Init(config).also { fresh ->
+          callback?.let { fresh.waiters.add(it) }
+          current = fresh
+        }
+      }
+    }
+    if (replay) {
+      callback?.invoke(null)
+    }
+    if (init == null) {
+      return
+    }
+    if (config.environment == ENVIRONMENT_STAND_IN) {
+      if (!standInAllowed) {
+        settle(init, "The stand-in environment is only available in debug builds")
+        return
+      }
+      // Nothing to initialise; the config is not persisted either, so a cold
+      // start never preinitialises into the stand-in by accident.
+      settle(init, null)
+      return
+    }
+    val sdkConfig = SPaySdkInitConfig(
+      application,
+      config.bnplPlan,
+      stageFor(config.environment),
+      SPayHelperConfig(config.helpers, mutableListOf<SPayHelpers>()),
+      config.resultViewNeeded,
+      config.needLogs
+    ) { initializationResult ->
+      when (initializationResult) {
+        is InitializationResult.Success -> {
+          save(application, config)
+          SPayFingerprint.prefetch()
+          settle(init, null)
+        }
+        is InitializationResult.ConfigError -> settle(init, initializationResult.message)
+      }
+    }
+    try {
+      SPaySdkApp.getInstance().initialize(sdkConfig)
+    } catch (e: Exception) {
+      settle(init, e.toString())
+    }
+  }
+
+  // A release build that passes the stand-in environment by mistake must not
+  // report itself ready and answer payments without the SDK.
+  private val standInAllowed: Boolean
+    get() = BuildConfig.DEBUG || BuildConfig.STAND_IN_ENABLED
+
+  /** Whether payments go to [StandInBackend] instead of the SDK. */
+  val isStandIn: Boolean
+    get() = synchronized(this) {
+      val init = current
+      init != null && init.config.environment == ENVIRONMENT_STAND_IN && init.state == STATE_READY
+    }
+
+  fun isReady(application: Application): Boolean =
+    isStandIn || SPaySdkApp.getInstance().isReadyForSPaySdk(application)
+
+  fun snapshot(): Snapshot? = synchronized(this) {
+    current?.let { Snapshot(it.config, it.state, it.error) }
+  }
+
+  private fun stageFor(environment: Int): SPayStage = when (environment) {
+    ENVIRONMENT_SANDBOX_WITHOUT_BANK_APP -> SPayStage.SandBoxWithoutBankApp
+    ENVIRONMENT_SANDBOX_REAL_BANK_APP -> SPayStage.SandboxRealBankApp
+    else -> SPayStage.Prod
+  }
+
+  private fun settle(init: Init, error: String?) {
+    val waiters = synchronized(this) {
+      init.state = if (error == null) STATE_READY else STATE_FAILED
+      init.error = error
+      init.waiters.toList().also { init.waiters.clear() }
+    }
+    waiters.forEach { it(error) }
+  }
+
+  private fun load(context: Context): Config? {
+    val json = context.getSharedPreferences(PREFS_NAME, Context.MODE_PRIVATE).getString(CONFIG_KEY, null)
+    return json?.let { Config.fromJson(it) }
+  }
+
+  private fun save(context: Context, config: Config) {
+    context.getSharedPreferences(PREFS_NAME, Context.MODE_PRIVATE)
+      .edit()
+      .putString(CONFIG_KEY, config.toJson())
+      .apply()
+  }
+}
@@ -0,0 +1,69 @@
+package com.demoproject
+
+import com.facebook.proguard.annotations.DoNotStrip
+
+/**
+ * Stand-in for the SDK used by the stand-in environment (`SDKEnvironment.EnvironmentStandIn`):
+ * payments are answered by the scripted backend of the C++ core (`cpp/ScriptedPlatformBackend.h`)
+ * after a drawn latency, without a bank, network or sheet. Meant for offline end-to-end
+ * throughput and latency runs of the bridge.
+ */
+object StandInBackend {
+  @DoNotStrip
+  internal fun interface Listener {
+    @DoNotStrip
+    fun onResult(state: Int, info: String?)
+  }
+
+  /**
+   * Replaces the script; until then every payment succeeds right away. Payments still
+   * pending with the previous script are answered with their scripted outcome first.
+   * Latencies are drawn uniformly from [minPayMillis, maxPayMillis], the rest of the
+   * payments succeed, and `waitingRatio` of them report waiting first.
+   */
+  @JvmStatic
+  @JvmOverloads
+  fun configure(
+    minPayMillis: Long = 50,
+    maxPayMillis: Long = 300,
+    errorRatio: Double = 0.0,
+    cancelRatio: Double = 0.0,
+    waitingRatio: Double = 0.0,
+    waitingToFinalMillis: Long = 0,
+    seed: Long = 1
+  ) {
+    require(minPayMillis in 0..maxPayMillis) { "Invalid latency range" }
+    require(errorRatio >= 0 && cancelRatio >= 0 && errorRatio + cancelRatio <= 1) { "Invalid outcome ratios" }
+    if (NativeLibrary.loaded) {
+      nativeConfigure(
+        minPayMillis * 1000, maxPayMillis * 1000, errorRatio, cancelRatio,
+        waitingRatio, waitingToFinalMillis * 1000, seed
+      )
+    }
+  }
+
+  internal fun pay(method: PayMethod, bankInvoiceId: String, listener: Listener) {
+    if (!NativeLibrary.loaded) {
+      listener.onResult(STATE_ERROR, "The stand-in backend is not available")
+      return
+    }
+    nativePay(method.ordinal, bankInvoiceId, listener)
+  }
+
+  // Must match spaybridge::PaymentState in cpp/SPayBridge.h.
+  private const val STATE_ERROR = 3
+
+  @JvmStatic
+  private external fun nativeConfigure(
+    minPayMicros: Long,
+    maxPayMicros: Long,
+    errorRatio: Double,
+    cancelRatio: Double,
+    waitingRatio: Double,
+    waitingToFinalMicros: Long,
+    seed: Long
+  )
+
+  @JvmStatic
+  private external fun nativePay(method: Int, bankInvoiceId: String, listener: Listener)
+}
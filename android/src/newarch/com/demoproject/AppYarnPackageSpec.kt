@@ -0,0 +1,6 @@
+package com.demoproject
+
+import com.facebook.react.bridge.ReactApplicationContext
+
+abstract class AppYarnPackageSpec internal constructor(context: ReactApplicationContext) :
+  NativeAppYarnPackageSpec(context)
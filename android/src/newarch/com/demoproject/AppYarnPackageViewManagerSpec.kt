@@ -0,0 +1,20 @@
+package com.demoproject
+
+import android.view.View
+
+import com.facebook.react.uimanager.SimpleViewManager
+import com.facebook.react.uimanager.ViewManagerDelegate
+import com.facebook.react.viewmanagers.AppYarnPackageViewManagerDelegate
+import com.facebook.react.viewmanagers.AppYarnPackageViewManagerInterface
+
+abstract class AppYarnPackageViewManagerSpec<T : View> : SimpleViewManager<T>(), AppYarnPackageViewManagerInterface<T> {
+  private val mDelegate: ViewManagerDelegate<T>
+
+  init {
+    mDelegate = AppYarnPackageViewManagerDelegate(this)
+  }
+
+  override fun getDelegate(): ViewManagerDelegate<T>? {
+    return mDelegate
+  }
+}
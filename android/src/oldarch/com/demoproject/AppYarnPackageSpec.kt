@@ -0,0 +1,38 @@
+package com.demoproject
+
+import com.facebook.react.bridge.Callback
+import com.facebook.react.bridge.ReactApplicationContext
+import com.facebook.react.bridge.ReactContextBaseJavaModule
+import com.facebook.react.bridge.ReadableMap
+
+abstract class AppYarnPackageSpec internal constructor(context: ReactApplicationContext) :
+  ReactContextBaseJavaModule(context) {
+
+  abstract fun setupSDK(params: ReadableMap, environment: Double, callBack: Callback)
+
+  abstract fun isReadyForSPay(callBack: Callback)
+
+  abstract fun getStatus(callBack: Callback)
+
+  abstract fun payWithBankInvoiceId(requestParams: ReadableMap, callBack: Callback)
+
+  abstract fun payWithoutRefresh(requestParams: ReadableMap, callBack: Callback)
+
+  abstract fun payWithPartPay(requestParams: ReadableMap, callBack: Callback)
+
+  abstract fun cancelPayment(sessionId: String, callBack: Callback)
+
+  abstract fun abandonPayment(sessionId: String, code: Double)
+
+  abstract fun drainLatencyHistograms(callBack: Callback)
+
+  abstract fun installJSI(): Boolean
+
+  abstract fun getStoredValue(key: String, callBack: Callback)
+
+  abstract fun setStoredValue(key: String, value: String?)
+
+  abstract fun addListener(eventName: String)
+
+  abstract fun removeListeners(count: Double)
+}
@@ -0,0 +1,13 @@
+package com.demoproject
+
+import android.view.View
+import com.facebook.react.bridge.ReadableMap
+import com.facebook.react.uimanager.SimpleViewManager
+
+abstract class AppYarnPackageViewManagerSpec<T : View> : SimpleViewManager<T>() {
+  abstract fun setColor(view: T, color: Int?)
+
+  abstract fun setPaymentRequest(view: T, value: ReadableMap?)
+
+  abstract fun setPayMethod(view: T, value: String?)
+}
@@ -0,0 +1,165 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace spaybridge {
+
+namespace {
+
+int highestBit(uint64_t value) {
+  int bit = 0;
+  while (value >>= 1) {
+    ++bit;
+  }
+  return bit;
+}
+
+} // namespace
+
+size_t LatencyHistogram::bucketFor(uint64_t micros) {
+  constexpr uint64_t subBuckets = 1u << kSubBucketBits;
+  if (micros < subBuckets) {
+    return static_cast<size_t>(micros);
+  }
+  int exponent = highestBit(micros);
+  if (exponent > kMaxExponent) {
+    return kBucketCount - 1;
+  }
+  uint64_t sub = (micros >> (exponent - kSubBucketBits)) & (subBuckets - 1);
+  return (static_cast<size_t>(exponent - kSubBucketBits + 1) << kSubBucketBits) | sub;
+}
+
+uint64_t LatencyHistogram::lowerBound(size_t bucket) {
+  constexpr uint64_t subBuckets = 1u << kSubBucketBits;
+  if (bucket < subBuckets) {
+    return bucket;
+  }
+  int exponent = static_cast<int>(bucket >> kSubBucketBits) + kSubBucketBits - 1;
+  uint64_t sub = bucket & (subBuckets - 1);
+  return (subBuckets + sub) << (exponent - kSubBucketBits);
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+  ++buckets_[bucketFor(micros)];
+  ++count_;
+  sum_ += micros;
+  min_ = std::min(min_, micros);
+  max_ = std::max(max_, micros);
+}
+
+void LatencyHistogram::reset() {
+  buckets_.fill(0);
+  count_ = 0;
+  sum_ = 0;
+  min_ = UINT64_MAX;
+  max_ = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * count_));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+    seen += buckets_[bucket];
+    if (seen >= rank) {
+      uint64_t low = lowerBound(bucket);
+      uint64_t high = bucket + 1 < kBucketCount ? lowerBound(bucket + 1) : max_ + 1;
+      return std::clamp(low + (high - low) / 2, min_, max_);
+    }
+  }
+  return max_;
+}
+
+Operation operationFor(PayMethod method) {
+  switch (method) {
+    case PayMethod::BankInvoiceId:
+      return Operation::PayBankInvoiceId;
+    case PayMethod::WithoutRefresh:
+      return Operation::PayWithoutRefresh;
+    case PayMethod::PartPay:
+      return Operation::PayPartPay;
+  }
+  return Operation::PayBankInvoiceId;
+}
+
+const char *toString(Operation operation) {
+  switch (operation) {
+    case Operation::Setup:
+      return "setupSDK";
+    case Operation::IsReady:
+      return "isReadyForSPay";
+    case Operation::PayBankInvoiceId:
+      return toString(PayMethod::BankInvoiceId);
+    case Operation::PayWithoutRefresh:
+      return toString(PayMethod::WithoutRefresh);
+    case Operation::PayPartPay:
+      return toString(PayMethod::PartPay);
+  }
+  return "unknown";
+}
+
+LatencyRecorder &LatencyRecorder::shared() {
+  static LatencyRecorder recorder;
+  return recorder;
+}
+
+void LatencyRecorder::record(Operation operation, PaymentState outcome, Clock::duration elapsed) {
+  auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  std::lock_guard<std::mutex> lock(mutex_);
+  histograms_[static_cast<size_t>(operation)][static_cast<size_t>(outcome)].record(
+      static_cast<uint64_t>(std::max<decltype(micros)>(micros, 0)));
+}
+
+std::vector<HistogramSummary> LatencyRecorder::drain() {
+  std::vector<HistogramSummary> summaries;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t op = 0; op < kOperationCount; ++op) {
+    for (size_t outcome = 0; outcome < kOutcomeCount; ++outcome) {
+      LatencyHistogram &histogram = histograms_[op][outcome];
+      if (histogram.count() == 0) {
+        continue;
+      }
+      auto operation = static_cast<Operation>(op);
+      HistogramSummary summary;
+      summary.name = toString(operation);
+      if (operation != Operation::IsReady) {
+        summary.name += ".";
+        summary.name += toString(static_cast<PaymentState>(outcome));
+      }
+      summary.count = histogram.count();
+      summary.minMicros = histogram.min();
+      summary.maxMicros = histogram.max();
+      summary.meanMicros = histogram.mean();
+      summary.p50Micros = histogram.percentile(0.5);
+      summary.p90Micros = histogram.percentile(0.9);
+      summary.p99Micros = histogram.percentile(0.99);
+      summaries.push_back(std::move(summary));
+      histogram.reset();
+    }
+  }
+  return summaries;
+}
+
+// Names are fixed identifiers, so no string escaping is needed.
+std::string toJson(const std::vector<HistogramSummary> &summaries) {
+  std::ostringstream out;
+  // Means of long calls exceed the default 6 significant digits; without fixed
+  // they would be written in exponent notation.
+  out << std::fixed << std::setprecision(1) << "[";
+  for (size_t i = 0; i < summaries.size(); ++i) {
+    const HistogramSummary &s = summaries[i];
+    out << (i ? "," : "") << "{\"name\":\"" << s.name << "\",\"count\":" << s.count << ",\"minMicros\":" << s.minMicros
+        << ",\"maxMicros\":" << s.maxMicros << ",\"meanMicros\":" << s.meanMicros << ",\"p50Micros\":" << s.p50Micros
+        << ",\"p90Micros\":" << s.p90Micros << ",\"p99Micros\":" << s.p99Micros << "}";
+  }
+  out << "]";
+  return out.str();
+}
+
+} // namespace spaybridge
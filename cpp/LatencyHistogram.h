@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "SPayBridge.h"
+
+namespace spaybridge {
+
+// Log-linear histogram of latencies in microseconds: every power of two is
+// split into 8 linear sub-buckets, so a percentile is off by at most 12.5%.
+// Memory is fixed (~1 KB); values past ~71 minutes land in the last bucket.
+class LatencyHistogram {
+public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kMaxExponent = 31;
+  static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 2) << kSubBucketBits;
+
+  void record(uint64_t micros);
+  void reset();
+
+  uint64_t count() const { return count_; }
+  uint64_t min() const { return count_ ? min_ : 0; }
+  uint64_t max() const { return max_; }
+  double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0; }
+
+  // Midpoint of the bucket holding the q-th quantile (0..1), clamped to the
+  // observed min/max.
+  uint64_t percentile(double q) const;
+
+  static size_t bucketFor(uint64_t micros);
+  static uint64_t lowerBound(size_t bucket);
+
+private:
+  std::array<uint32_t, kBucketCount> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = UINT64_MAX;
+  uint64_t max_ = 0;
+};
+
+// Operations whose latency the native modules record.
+enum class Operation : int {
+  Setup = 0,
+  IsReady = 1,
+  PayBankInvoiceId = 2,
+  PayWithoutRefresh = 3,
+  PayPartPay = 4,
+};
+
+Operation operationFor(PayMethod method);
+const char *toString(Operation operation);
+
+struct HistogramSummary {
+  std::string name;
+  uint64_t count = 0;
+  uint64_t minMicros = 0;
+  uint64_t maxMicros = 0;
+  double meanMicros = 0;
+  uint64_t p50Micros = 0;
+  uint64_t p90Micros = 0;
+  uint64_t p99Micros = 0;
+};
+
+// One histogram per operation and outcome. Setup records Success or Error,
+// isReady always Success. Thread safe.
+class LatencyRecorder {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static LatencyRecorder &shared();
+
+  void record(Operation operation, PaymentState outcome, Clock::duration elapsed);
+  void record(Operation operation, PaymentState outcome, Clock::time_point startedAt) {
+    record(operation, outcome, Clock::now() - startedAt);
+  }
+
+  // Summaries of the non-empty histograms, named `<operation>.<outcome>`
+  // (`isReadyForSPay` has no suffix); the histograms are reset.
+  std::vector<HistogramSummary> drain();
+
+private:
+  static constexpr size_t kOperationCount = 5;
+  static constexpr size_t kOutcomeCount = 4;
+
+  std::mutex mutex_;
+  std::array<std::array<LatencyHistogram, kOutcomeCount>, kOperationCount> histograms_;
+};
+
+std::string toJson(const std::vector<HistogramSummary> &summaries);
+
+} // namespace spaybridge
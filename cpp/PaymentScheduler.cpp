@@ -0,0 +1,152 @@
+#include "PaymentScheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace spaybridge {
+
+SchedulingPolicy schedulingPolicyFromString(const std::string &policy) {
+  if (policy == "reject") {
+    return SchedulingPolicy::Reject;
+  }
+  if (policy == "replace") {
+    return SchedulingPolicy::Replace;
+  }
+  return SchedulingPolicy::Enqueue;
+}
+
+const char *toString(DropReason reason) {
+  switch (reason) {
+    case DropReason::Cancelled:
+      return "cancelled";
+    case DropReason::Rejected:
+      return "rejected";
+    case DropReason::Replaced:
+      return "replaced";
+  }
+  return "cancelled";
+}
+
+const char *describe(DropReason reason) {
+  switch (reason) {
+    case DropReason::Cancelled:
+      return "The payment was cancelled before it started";
+    case DropReason::Rejected:
+      return "Another payment is in progress";
+    case DropReason::Replaced:
+      return "The payment was replaced by a newer one";
+  }
+  return "The payment was cancelled before it started";
+}
+
+std::shared_ptr<PaymentScheduler> PaymentScheduler::shared() {
+  static auto scheduler = std::make_shared<PaymentScheduler>();
+  return scheduler;
+}
+
+PaymentScheduler::PaymentScheduler(std::chrono::milliseconds maxActive) : maxActive_(maxActive) {}
+
+std::optional<PaymentScheduler::Job> PaymentScheduler::advanceLocked() {
+  if (waiting_.empty()) {
+    active_.reset();
+    return std::nullopt;
+  }
+  Job next = std::move(waiting_.front());
+  waiting_.erase(waiting_.begin());
+  active_ = next.id;
+  activeSince_ = std::chrono::steady_clock::now();
+  return next;
+}
+
+void PaymentScheduler::submit(SchedulingPolicy policy, Job job) {
+  enum class Decision { Start, Reject, Wait } decision;
+  std::optional<Job> unstuck;
+  std::vector<Job> replaced;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (active_ && std::chrono::steady_clock::now() - activeSince_ >= maxActive_) {
+      // The active job's sheet never reported back; stop waiting for it.
+      unstuck = advanceLocked();
+    }
+    if (!active_) {
+      active_ = job.id;
+      activeSince_ = std::chrono::steady_clock::now();
+      decision = Decision::Start;
+    } else if (policy == SchedulingPolicy::Reject) {
+      decision = Decision::Reject;
+    } else {
+      if (policy == SchedulingPolicy::Replace) {
+        replaced.swap(waiting_);
+      }
+      auto position = std::find_if(waiting_.begin(), waiting_.end(),
+                                   [&](const Job &waiting) { return waiting.priority < job.priority; });
+      waiting_.insert(position, std::move(job));
+      decision = Decision::Wait;
+    }
+  }
+  if (unstuck) {
+    unstuck->start();
+  }
+  for (auto &dropped : replaced) {
+    dropped.drop(DropReason::Replaced);
+  }
+  if (decision == Decision::Start) {
+    job.start();
+  } else if (decision == Decision::Reject) {
+    job.drop(DropReason::Rejected);
+  }
+}
+
+void PaymentScheduler::finish(const std::string &id) {
+  std::optional<Job> next;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (active_ != id) {
+      return;
+    }
+    next = advanceLocked();
+  }
+  if (next) {
+    next->start();
+  }
+}
+
+bool PaymentScheduler::cancel(const std::string &id) {
+  Job cancelled;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(waiting_.begin(), waiting_.end(), [&](const Job &job) { return job.id == id; });
+    if (it == waiting_.end()) {
+      return false;
+    }
+    cancelled = std::move(*it);
+    waiting_.erase(it);
+  }
+  cancelled.drop(DropReason::Cancelled);
+  return true;
+}
+
+bool PaymentScheduler::release(const std::string &id) {
+  bool isActive;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    isActive = active_ == id;
+  }
+  if (!isActive) {
+    return cancel(id);
+  }
+  finish(id);
+  return true;
+}
+
+std::optional<std::string> PaymentScheduler::active() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return active_;
+}
+
+size_t PaymentScheduler::waiting() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return waiting_.size();
+}
+
+} // namespace spaybridge
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace spaybridge {
+
+// What to do with a payment submitted while another one's sheet is on screen.
+// The SDK can't dismiss a presented sheet, so no policy interrupts the active
+// payment; Replace drops the payments still waiting instead.
+enum class SchedulingPolicy : int {
+  Enqueue = 0,
+  Reject = 1,
+  Replace = 2,
+};
+
+enum class DropReason : int {
+  Cancelled = 0,
+  Rejected = 1,
+  Replaced = 2,
+};
+
+SchedulingPolicy schedulingPolicyFromString(const std::string &policy);
+const char *toString(DropReason reason);
+const char *describe(DropReason reason);
+
+// Lets one payment sheet be on screen at a time. Waiting jobs start in order
+// of priority (higher first), then submission. Job callbacks always run
+// outside the scheduler's lock and may call back into it.
+//
+// An active job whose SDK never reports a state would hold the slot forever,
+// so callers that give up on a payment release it, and a job active for
+// longer than `maxActive` is released by the next submit.
+class PaymentScheduler {
+public:
+  static constexpr std::chrono::milliseconds kDefaultMaxActive = std::chrono::minutes(10);
+
+  struct Job {
+    std::string id;
+    int priority = 0;
+    std::function<void()> start;
+    std::function<void(DropReason reason)> drop;
+  };
+
+  // Shared by the native module and the JSI bridge of the process.
+  static std::shared_ptr<PaymentScheduler> shared();
+
+  explicit PaymentScheduler(std::chrono::milliseconds maxActive = kDefaultMaxActive);
+
+  void submit(SchedulingPolicy policy, Job job);
+
+  // Called once the active job's sheet has closed, i.e. on its first reported
+  // state; starts the next waiting job. Ignored for any other id.
+  void finish(const std::string &id);
+
+  // Drops a waiting job with DropReason::Cancelled. Returns false for the
+  // active job and unknown ids.
+  bool cancel(const std::string &id);
+
+  // Frees the slot of an active job as if it had finished, or cancels a
+  // waiting one. For payments given up on whose sheet may never report back.
+  // Returns false for unknown ids.
+  bool release(const std::string &id);
+
+  std::optional<std::string> active() const;
+  size_t waiting() const;
+
+private:
+  // Hands the slot to the next waiting job, returned to be started outside
+  // the lock, or empties it.
+  std::optional<Job> advanceLocked();
+
+  const std::chrono::milliseconds maxActive_;
+  mutable std::mutex mutex_;
+  std::optional<std::string> active_;
+  std::chrono::steady_clock::time_point activeSince_;
+  std::vector<Job> waiting_;
+};
+
+} // namespace spaybridge
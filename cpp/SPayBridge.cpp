@@ -0,0 +1,244 @@
+#include "SPayBridge.h"
+
+#include "PaymentScheduler.h"
+
+#include <utility>
+
+namespace spaybridge {
+
+bool SetupConfig::operator==(const SetupConfig &other) const {
+  return bnplPlan == other.bnplPlan && resultViewNeeded == other.resultViewNeeded && helpers == other.helpers &&
+         needLogs == other.needLogs && sbp == other.sbp && creditCard == other.creditCard &&
+         debitCard == other.debitCard && environment == other.environment;
+}
+
+const char *toString(PaymentState state) {
+  switch (state) {
+    case PaymentState::Success:
+      return "success";
+    case PaymentState::Waiting:
+      return "waiting";
+    case PaymentState::Cancel:
+      return "cancel";
+    case PaymentState::Error:
+      return "error";
+  }
+  return "error";
+}
+
+const char *toString(PayMethod method) {
+  switch (method) {
+    case PayMethod::BankInvoiceId:
+      return "payWithBankInvoiceId";
+    case PayMethod::WithoutRefresh:
+      return "payWithoutRefresh";
+    case PayMethod::PartPay:
+      return "payWithPartPay";
+  }
+  return "payWithBankInvoiceId";
+}
+
+const char *toString(ErrorCategory category) {
+  switch (category) {
+    case ErrorCategory::None:
+      return "none";
+    case ErrorCategory::Sdk:
+      return "sdk";
+    case ErrorCategory::Presentation:
+      return "presentation";
+    case ErrorCategory::Scheduling:
+      return "scheduling";
+    case ErrorCategory::Internal:
+      return "internal";
+  }
+  return "none";
+}
+
+ErrorCategory categoryFor(PaymentState state) {
+  return state == PaymentState::Error ? ErrorCategory::Sdk : ErrorCategory::None;
+}
+
+bool isFinal(PaymentState state) {
+  return state != PaymentState::Waiting;
+}
+
+SPayBridge::SPayBridge(std::shared_ptr<PlatformBackend> backend, std::shared_ptr<PaymentScheduler> scheduler)
+    : backend_(std::move(backend)), scheduler_(std::move(scheduler)) {}
+
+void SPayBridge::setup(const SetupConfig &config, SetupCallback callback) {
+  std::shared_ptr<SetupState> state;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (setup_ && setup_->config == config) {
+      if (setup_->pending) {
+        setup_->waiters.push_back(std::move(callback));
+        return;
+      }
+    } else {
+      state = std::make_shared<SetupState>();
+      state->config = config;
+      state->waiters.push_back(std::move(callback));
+      setup_ = state;
+    }
+  }
+  if (!state) {
+    callback(std::nullopt);
+    return;
+  }
+  std::weak_ptr<SPayBridge> weakSelf = weak_from_this();
+  backend_->setup(config, [weakSelf, state](const std::optional<std::string> &error) {
+    if (auto self = weakSelf.lock()) {
+      self->onSetupResult(state, error);
+    }
+  });
+}
+
+void SPayBridge::onSetupResult(const std::shared_ptr<SetupState> &state, const std::optional<std::string> &error) {
+  std::vector<SetupCallback> waiters;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state->pending = false;
+    waiters.swap(state->waiters);
+    if (error && setup_ == state) {
+      // Forget failed inits so the next call retries instead of replaying the error.
+      setup_.reset();
+    }
+  }
+  if (!error) {
+    refreshReadiness();
+  }
+  for (auto &waiter : waiters) {
+    waiter(error);
+  }
+}
+
+std::optional<bool> SPayBridge::isReady() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return readiness_;
+}
+
+bool SPayBridge::refreshReadiness() {
+  bool isReady = backend_->isReady();
+  updateReadiness(isReady);
+  return isReady;
+}
+
+void SPayBridge::updateReadiness(bool isReady) {
+  ReadinessListener listener;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (readiness_ == isReady) {
+      return;
+    }
+    readiness_ = isReady;
+    listener = readinessListener_;
+  }
+  if (listener) {
+    listener(isReady);
+  }
+}
+
+void SPayBridge::setReadinessListener(ReadinessListener listener) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  readinessListener_ = std::move(listener);
+}
+
+void SPayBridge::pay(PayMethod method, const PaymentRequest &request, PaymentCallback callback) {
+  // Paying an invoice in parts is a different payment from paying it at once.
+  const std::string key = std::string(toString(method)) + ":" + request.bankInvoiceId;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = payments_.find(key);
+    if (it != payments_.end()) {
+      it->second.push_back(std::move(callback));
+      return;
+    }
+    payments_[key].push_back(std::move(callback));
+  }
+  // The first report settles the callers and frees the sheet's slot; any
+  // later one, e.g. the final state after Waiting, goes to the listener.
+  std::weak_ptr<SPayBridge> weakSelf = weak_from_this();
+  auto reported = std::make_shared<std::atomic<bool>>(false);
+  auto report = [weakSelf, method, request, key, reported](const PaymentOutcome &outcome) {
+    bool first = !reported->exchange(true);
+    if (auto self = weakSelf.lock()) {
+      if (first) {
+        self->onPaymentResult(key, outcome);
+      } else {
+        self->onLaterPaymentState(method, request, outcome);
+      }
+    }
+    return first;
+  };
+  if (!scheduler_) {
+    backend_->pay(method, request, [report](const PaymentOutcome &outcome) { report(outcome); });
+    return;
+  }
+
+  // The scheduler outlives any one bridge, so the slot is released through it
+  // directly even when the bridge has gone with its runtime in the meantime.
+  std::shared_ptr<PaymentScheduler> scheduler = scheduler_;
+  PaymentScheduler::Job job;
+  job.id = "jsi:" + std::to_string(nextTicket_++);
+  job.start = [weakSelf, scheduler, method, request, report, id = job.id] {
+    auto self = weakSelf.lock();
+    if (!self) {
+      scheduler->finish(id);
+      return;
+    }
+    self->backend_->pay(method, request, [scheduler, report, id](const PaymentOutcome &outcome) {
+      if (report(outcome)) {
+        scheduler->finish(id);
+      }
+    });
+  };
+  job.drop = [report](DropReason reason) {
+    PaymentOutcome outcome;
+    outcome.state = reason == DropReason::Cancelled ? PaymentState::Cancel : PaymentState::Error;
+    outcome.info = describe(reason);
+    if (reason != DropReason::Cancelled) {
+      outcome.category = ErrorCategory::Scheduling;
+    }
+    report(outcome);
+  };
+  scheduler_->submit(SchedulingPolicy::Enqueue, std::move(job));
+}
+
+void SPayBridge::onPaymentResult(const std::string &key, const PaymentOutcome &outcome) {
+  std::vector<PaymentCallback> waiters;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = payments_.find(key);
+    if (it == payments_.end()) {
+      return;
+    }
+    waiters = std::move(it->second);
+    payments_.erase(it);
+  }
+  for (auto &waiter : waiters) {
+    waiter(outcome);
+  }
+}
+
+void SPayBridge::onLaterPaymentState(PayMethod method, const PaymentRequest &request, const PaymentOutcome &outcome) {
+  PaymentStateListener listener;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener = paymentStateListener_;
+  }
+  if (listener) {
+    listener(method, request, outcome);
+  }
+}
+
+void SPayBridge::setPaymentStateListener(PaymentStateListener listener) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  paymentStateListener_ = std::move(listener);
+}
+
+size_t SPayBridge::inFlightPayments() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return payments_.size();
+}
+
+} // namespace spaybridge
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace spaybridge {
+
+class PaymentScheduler;
+
+enum class Environment : int {
+  Prod = 0,
+  SandboxWithoutBankApp = 1,
+  SandboxRealBankApp = 2,
+  // Payments are answered by a ScriptedPlatformBackend (Android only).
+  StandIn = 3,
+};
+
+struct SetupConfig {
+  bool bnplPlan = false;
+  bool resultViewNeeded = false;
+  bool helpers = false;
+  bool needLogs = false;
+  bool sbp = false;
+  bool creditCard = false;
+  bool debitCard = false;
+  Environment environment = Environment::Prod;
+
+  bool operator==(const SetupConfig &other) const;
+  bool operator!=(const SetupConfig &other) const { return !(*this == other); }
+};
+
+enum class PayMethod : int {
+  BankInvoiceId = 0,
+  WithoutRefresh = 1,
+  PartPay = 2,
+};
+
+struct PaymentRequest {
+  std::string merchantLogin;
+  std::string bankInvoiceId;
+  std::string orderNumber;
+  std::string language;
+  std::string redirectUri;
+  std::string apiKey;
+};
+
+enum class PaymentState : int {
+  Success = 0,
+  Waiting = 1,
+  Cancel = 2,
+  Error = 3,
+};
+
+// Why a payment failed, so callers can classify it without parsing `info`.
+enum class ErrorCategory : int {
+  None = 0,
+  // The SDK reported an error.
+  Sdk = 1,
+  // There was no screen to present the payment sheet from.
+  Presentation = 2,
+  // Another payment's sheet kept this one from starting.
+  Scheduling = 3,
+  // The request never reached the SDK, e.g. it was malformed.
+  Internal = 4,
+};
+
+struct PaymentOutcome {
+  PaymentState state = PaymentState::Error;
+  std::string info;
+  std::string localSessionId;
+  ErrorCategory category = ErrorCategory::None;
+};
+
+const char *toString(PaymentState state);
+const char *toString(PayMethod method);
+const char *toString(ErrorCategory category);
+bool isFinal(PaymentState state);
+// The category of a state reported by the SDK itself.
+ErrorCategory categoryFor(PaymentState state);
+
+using SetupCallback = std::function<void(const std::optional<std::string> &error)>;
+using PaymentCallback = std::function<void(const PaymentOutcome &outcome)>;
+using ReadinessListener = std::function<void(bool isReady)>;
+// States a payment reports after its first one, e.g. the final state after Waiting.
+using PaymentStateListener =
+    std::function<void(PayMethod method, const PaymentRequest &request, const PaymentOutcome &outcome)>;
+
+// Implemented once per platform on top of the native SDK (SPay on iOS,
+// SPaySdkApp on Android) and by fakes in tests. Callbacks may be invoked on any
+// thread; a payment callback may fire more than once (Waiting, then final).
+class PlatformBackend {
+public:
+  virtual ~PlatformBackend() = default;
+
+  virtual void setup(const SetupConfig &config, SetupCallback callback) = 0;
+  virtual bool isReady() = 0;
+  virtual void pay(PayMethod method, const PaymentRequest &request, PaymentCallback callback) = 0;
+};
+
+// Platform independent core of the payment bridge. It owns the state that both
+// the legacy module and the JSI host object need answered without a bridge hop:
+// the last setup config, the cached readiness value and the in-flight payments.
+// Must be owned by a std::shared_ptr: backend and scheduler callbacks only hold
+// it weakly, so a bridge scoped to a JS runtime can go away with pending calls.
+class SPayBridge : public std::enable_shared_from_this<SPayBridge> {
+public:
+  // With a scheduler, backend payments wait for any other payment sheet of
+  // the process to close first.
+  explicit SPayBridge(std::shared_ptr<PlatformBackend> backend,
+                      std::shared_ptr<PaymentScheduler> scheduler = nullptr);
+
+  // Identical configs join a pending init or are answered from the last
+  // successful one; only a changed config re-initialises the SDK.
+  void setup(const SetupConfig &config, SetupCallback callback);
+
+  // Cached readiness, std::nullopt until it has been read once.
+  std::optional<bool> isReady() const;
+  bool refreshReadiness();
+  void updateReadiness(bool isReady);
+  void setReadinessListener(ReadinessListener listener);
+
+  // Concurrent calls with the same method and bankInvoiceId share one backend
+  // call. Every caller receives its first reported state, Waiting included,
+  // which also ends the call's in-flight entry; later states only go to the
+  // payment state listener, since the SDK may never report again after Waiting.
+  void pay(PayMethod method, const PaymentRequest &request, PaymentCallback callback);
+  size_t inFlightPayments() const;
+  void setPaymentStateListener(PaymentStateListener listener);
+
+private:
+  struct SetupState {
+    SetupConfig config;
+    bool pending = true;
+    std::vector<SetupCallback> waiters;
+  };
+
+  void onSetupResult(const std::shared_ptr<SetupState> &state, const std::optional<std::string> &error);
+  void onPaymentResult(const std::string &key, const PaymentOutcome &outcome);
+  void onLaterPaymentState(PayMethod method, const PaymentRequest &request, const PaymentOutcome &outcome);
+
+  std::shared_ptr<PlatformBackend> backend_;
+  std::shared_ptr<PaymentScheduler> scheduler_;
+  std::atomic<uint64_t> nextTicket_{1};
+
+  mutable std::mutex mutex_;
+  std::shared_ptr<SetupState> setup_;
+  std::optional<bool> readiness_;
+  ReadinessListener readinessListener_;
+  PaymentStateListener paymentStateListener_;
+  std::unordered_map<std::string, std::vector<PaymentCallback>> payments_;
+};
+
+} // namespace spaybridge
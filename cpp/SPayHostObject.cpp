@@ -0,0 +1,212 @@
+#include "SPayHostObject.h"
+
+#include <optional>
+#include <utility>
+
+namespace spaybridge {
+
+namespace jsi = facebook::jsi;
+
+namespace {
+
+constexpr const char *kGlobalName = "__SPayBridge";
+
+bool boolProperty(jsi::Runtime &runtime, const jsi::Object &object, const char *name) {
+  jsi::Value value = object.getProperty(runtime, name);
+  return value.isBool() && value.getBool();
+}
+
+std::string stringProperty(jsi::Runtime &runtime, const jsi::Object &object, const char *name) {
+  jsi::Value value = object.getProperty(runtime, name);
+  return value.isString() ? value.getString(runtime).utf8(runtime) : std::string();
+}
+
+PaymentRequest paymentRequestFrom(jsi::Runtime &runtime, const jsi::Object &object) {
+  PaymentRequest request;
+  request.merchantLogin = stringProperty(runtime, object, "merchantLogin");
+  request.bankInvoiceId = stringProperty(runtime, object, "bankInvoiceId");
+  request.orderNumber = stringProperty(runtime, object, "orderNumber");
+  request.language = stringProperty(runtime, object, "language");
+  request.redirectUri = stringProperty(runtime, object, "redirectUri");
+  request.apiKey = stringProperty(runtime, object, "apiKey");
+  return request;
+}
+
+} // namespace
+
+SPayHostObject::SPayHostObject(jsi::Runtime &runtime, std::shared_ptr<SPayBridge> bridge,
+                               std::shared_ptr<facebook::react::CallInvoker> callInvoker)
+    : runtime_(runtime), bridge_(std::move(bridge)), callInvoker_(std::move(callInvoker)) {}
+
+void SPayHostObject::install(jsi::Runtime &runtime, std::shared_ptr<SPayBridge> bridge,
+                             std::shared_ptr<facebook::react::CallInvoker> callInvoker) {
+  auto hostObject = std::make_shared<SPayHostObject>(runtime, bridge, callInvoker);
+  std::weak_ptr<SPayHostObject> weakHost = hostObject;
+  bridge->setPaymentStateListener(
+      [weakHost, callInvoker](PayMethod method, const PaymentRequest &request, const PaymentOutcome &outcome) {
+        runOnJS(weakHost, callInvoker,
+                [method, bankInvoiceId = request.bankInvoiceId, outcome](SPayHostObject &host) {
+                  if (!host.stateListener_) {
+                    return;
+                  }
+                  jsi::Runtime &jsRuntime = host.runtime_;
+                  host.stateListener_->call(
+                      jsRuntime, jsi::String::createFromAscii(jsRuntime, toString(method)),
+                      jsi::String::createFromUtf8(jsRuntime, bankInvoiceId),
+                      jsi::String::createFromAscii(jsRuntime, toString(outcome.state)),
+                      jsi::String::createFromUtf8(jsRuntime, outcome.info),
+                      outcome.localSessionId.empty()
+                          ? jsi::Value::null()
+                          : jsi::Value(jsi::String::createFromUtf8(jsRuntime, outcome.localSessionId)),
+                      jsi::Value(static_cast<int>(outcome.category)));
+                });
+      });
+  runtime.global().setProperty(runtime, kGlobalName, jsi::Object::createFromHostObject(runtime, hostObject));
+}
+
+void SPayHostObject::runOnJS(const std::weak_ptr<SPayHostObject> &weakSelf,
+                             const std::shared_ptr<facebook::react::CallInvoker> &callInvoker,
+                             std::function<void(SPayHostObject &self)> work) {
+  callInvoker->invokeAsync([weakSelf, work = std::move(work)]() {
+    if (auto self = weakSelf.lock()) {
+      work(*self);
+    }
+  });
+}
+
+uint64_t SPayHostObject::retainCallback(jsi::Function callback) {
+  uint64_t id = nextCallbackId_++;
+  callbacks_.emplace(id, std::move(callback));
+  return id;
+}
+
+jsi::Value SPayHostObject::get(jsi::Runtime &runtime, const jsi::PropNameID &name) {
+  const std::string property = name.utf8(runtime);
+  if (property == "isReady") {
+    std::optional<bool> isReady = bridge_->isReady();
+    if (!isReady) {
+      isReady = bridge_->refreshReadiness();
+    }
+    return jsi::Value(*isReady);
+  }
+  if (property == "setup") {
+    return makeSetup(runtime);
+  }
+  if (property == "payWithBankInvoiceId") {
+    return makePay(runtime, "payWithBankInvoiceId", PayMethod::BankInvoiceId);
+  }
+  if (property == "payWithoutRefresh") {
+    return makePay(runtime, "payWithoutRefresh", PayMethod::WithoutRefresh);
+  }
+  if (property == "payWithPartPay") {
+    return makePay(runtime, "payWithPartPay", PayMethod::PartPay);
+  }
+  if (property == "setPaymentStateListener") {
+    return makeSetPaymentStateListener(runtime);
+  }
+  return jsi::Value::undefined();
+}
+
+std::vector<jsi::PropNameID> SPayHostObject::getPropertyNames(jsi::Runtime &runtime) {
+  std::vector<jsi::PropNameID> names;
+  for (const char *name : {"isReady", "setup", "payWithBankInvoiceId", "payWithoutRefresh", "payWithPartPay",
+                           "setPaymentStateListener"}) {
+    names.push_back(jsi::PropNameID::forAscii(runtime, name));
+  }
+  return names;
+}
+
+// setup(params, environment, callback(errorString | null))
+jsi::Function SPayHostObject::makeSetup(jsi::Runtime &runtime) {
+  return jsi::Function::createFromHostFunction(
+      runtime, jsi::PropNameID::forAscii(runtime, "setup"), 3,
+      [self = shared_from_this()](jsi::Runtime &rt, const jsi::Value &, const jsi::Value *args,
+                                  size_t count) -> jsi::Value {
+        if (count < 3 || !args[0].isObject() || !args[2].isObject()) {
+          throw jsi::JSError(rt, "setup(params, environment, callback) expects 3 arguments");
+        }
+        jsi::Object params = args[0].getObject(rt);
+        SetupConfig config;
+        config.bnplPlan = boolProperty(rt, params, "bnplPlan");
+        config.resultViewNeeded = boolProperty(rt, params, "resultViewNeeded");
+        config.helpers = boolProperty(rt, params, "helpers");
+        config.needLogs = boolProperty(rt, params, "needLogs");
+        config.sbp = boolProperty(rt, params, "sbp");
+        config.creditCard = boolProperty(rt, params, "creditCard");
+        config.debitCard = boolProperty(rt, params, "debitCard");
+        config.environment = static_cast<Environment>(args[1].isNumber() ? static_cast<int>(args[1].getNumber()) : 0);
+
+        uint64_t id = self->retainCallback(args[2].getObject(rt).getFunction(rt));
+        std::weak_ptr<SPayHostObject> weakSelf = self;
+        std::shared_ptr<facebook::react::CallInvoker> callInvoker = self->callInvoker_;
+        self->bridge_->setup(config, [weakSelf, callInvoker, id](const std::optional<std::string> &error) {
+          runOnJS(weakSelf, callInvoker, [id, error](SPayHostObject &host) {
+            auto it = host.callbacks_.find(id);
+            if (it == host.callbacks_.end()) {
+              return;
+            }
+            jsi::Function callback = std::move(it->second);
+            host.callbacks_.erase(it);
+            jsi::Runtime &jsRuntime = host.runtime_;
+            jsi::Value errorValue =
+                error ? jsi::Value(jsi::String::createFromUtf8(jsRuntime, *error)) : jsi::Value::null();
+            callback.call(jsRuntime, errorValue);
+          });
+        });
+        return jsi::Value::undefined();
+      });
+}
+
+// payWith*(request, callback(state, info, localSessionId, category)), called once with the first state the
+// payment reports. Later states, e.g. the final one after Waiting, go to the payment state listener.
+jsi::Function SPayHostObject::makePay(jsi::Runtime &runtime, const char *name, PayMethod method) {
+  return jsi::Function::createFromHostFunction(
+      runtime, jsi::PropNameID::forAscii(runtime, name), 2,
+      [self = shared_from_this(), method](jsi::Runtime &rt, const jsi::Value &, const jsi::Value *args,
+                                          size_t count) -> jsi::Value {
+        if (count < 2 || !args[0].isObject() || !args[1].isObject()) {
+          throw jsi::JSError(rt, "pay(request, callback) expects 2 arguments");
+        }
+        PaymentRequest request = paymentRequestFrom(rt, args[0].getObject(rt));
+        uint64_t id = self->retainCallback(args[1].getObject(rt).getFunction(rt));
+        std::weak_ptr<SPayHostObject> weakSelf = self;
+        std::shared_ptr<facebook::react::CallInvoker> callInvoker = self->callInvoker_;
+        self->bridge_->pay(method, request, [weakSelf, callInvoker, id](const PaymentOutcome &outcome) {
+          runOnJS(weakSelf, callInvoker, [id, outcome](SPayHostObject &host) {
+            auto it = host.callbacks_.find(id);
+            if (it == host.callbacks_.end()) {
+              return;
+            }
+            jsi::Function callback = std::move(it->second);
+            host.callbacks_.erase(it);
+            jsi::Runtime &jsRuntime = host.runtime_;
+            callback.call(jsRuntime, jsi::String::createFromAscii(jsRuntime, toString(outcome.state)),
+                          jsi::String::createFromUtf8(jsRuntime, outcome.info),
+                          outcome.localSessionId.empty()
+                              ? jsi::Value::null()
+                              : jsi::Value(jsi::String::createFromUtf8(jsRuntime, outcome.localSessionId)),
+                          jsi::Value(static_cast<int>(outcome.category)));
+          });
+        });
+        return jsi::Value::undefined();
+      });
+}
+
+// setPaymentStateListener(listener(method, bankInvoiceId, state, info, localSessionId, category) | null)
+jsi::Function SPayHostObject::makeSetPaymentStateListener(jsi::Runtime &runtime) {
+  return jsi::Function::createFromHostFunction(
+      runtime, jsi::PropNameID::forAscii(runtime, "setPaymentStateListener"), 1,
+      [self = shared_from_this()](jsi::Runtime &rt, const jsi::Value &, const jsi::Value *args,
+                                  size_t count) -> jsi::Value {
+        if (count < 1 || args[0].isNull() || args[0].isUndefined()) {
+          self->stateListener_.reset();
+        } else if (args[0].isObject() && args[0].getObject(rt).isFunction(rt)) {
+          self->stateListener_.emplace(args[0].getObject(rt).getFunction(rt));
+        } else {
+          throw jsi::JSError(rt, "setPaymentStateListener(listener) expects a function or null");
+        }
+        return jsi::Value::undefined();
+      });
+}
+
+} // namespace spaybridge
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <jsi/jsi.h>
+#include <ReactCommon/CallInvoker.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+#include "SPayBridge.h"
+
+namespace spaybridge {
+
+// Exposes SPayBridge to JS as `global.__SPayBridge`. Arguments are read straight
+// from JS values instead of going through NSDictionary/ReadableMap, and
+// `isReady` is a synchronous property backed by the cached readiness.
+class SPayHostObject : public facebook::jsi::HostObject, public std::enable_shared_from_this<SPayHostObject> {
+public:
+  SPayHostObject(facebook::jsi::Runtime &runtime, std::shared_ptr<SPayBridge> bridge,
+                 std::shared_ptr<facebook::react::CallInvoker> callInvoker);
+
+  static void install(facebook::jsi::Runtime &runtime, std::shared_ptr<SPayBridge> bridge,
+                      std::shared_ptr<facebook::react::CallInvoker> callInvoker);
+
+  facebook::jsi::Value get(facebook::jsi::Runtime &runtime, const facebook::jsi::PropNameID &name) override;
+  std::vector<facebook::jsi::PropNameID> getPropertyNames(facebook::jsi::Runtime &runtime) override;
+
+private:
+  // Runs `work` on the JS thread if this host object is still alive. Safe to
+  // call from any thread: the host object is only locked on the JS thread, so
+  // it is never released anywhere else.
+  static void runOnJS(const std::weak_ptr<SPayHostObject> &weakSelf,
+                      const std::shared_ptr<facebook::react::CallInvoker> &callInvoker,
+                      std::function<void(SPayHostObject &self)> work);
+
+  uint64_t retainCallback(facebook::jsi::Function callback);
+
+  facebook::jsi::Function makeSetup(facebook::jsi::Runtime &runtime);
+  facebook::jsi::Function makePay(facebook::jsi::Runtime &runtime, const char *name, PayMethod method);
+  facebook::jsi::Function makeSetPaymentStateListener(facebook::jsi::Runtime &runtime);
+
+  facebook::jsi::Runtime &runtime_;
+  std::shared_ptr<SPayBridge> bridge_;
+  std::shared_ptr<facebook::react::CallInvoker> callInvoker_;
+  // JS callbacks of pending calls by id. Only touched on the JS thread, and
+  // released with the host object when the runtime goes away; the bridge's
+  // callbacks only carry the id.
+  std::unordered_map<uint64_t, facebook::jsi::Function> callbacks_;
+  uint64_t nextCallbackId_ = 1;
+  // Receives the states payments report after their first one. JS thread only.
+  std::optional<facebook::jsi::Function> stateListener_;
+};
+
+} // namespace spaybridge
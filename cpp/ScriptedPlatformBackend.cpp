@@ -0,0 +1,161 @@
+#include "ScriptedPlatformBackend.h"
+
+#include <algorithm>
+
+namespace spaybridge {
+
+namespace {
+
+// schedule() notifies the worker; this only bounds how long an idle worker
+// sleeps between checks.
+constexpr std::chrono::seconds kIdleWakeUp{1};
+
+} // namespace
+
+ScriptedPlatformBackend::ScriptedPlatformBackend(BackendScript script)
+    : script_(std::move(script)), random_(script_.seed), worker_([this] { runLoop(); }) {}
+
+ScriptedPlatformBackend::~ScriptedPlatformBackend() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wakeUp_.notify_all();
+  worker_.join();
+}
+
+void ScriptedPlatformBackend::setup(const SetupConfig &, SetupCallback callback) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.setupCalls;
+  }
+  schedule(script_.setupLatency, [callback = std::move(callback), error = script_.setupError] { callback(error); });
+}
+
+bool ScriptedPlatformBackend::isReady() { return script_.ready; }
+
+void ScriptedPlatformBackend::pay(PayMethod, const PaymentRequest &request, PaymentCallback callback) {
+  std::chrono::microseconds latency;
+  PaymentState state;
+  bool waitingFirst;
+  uint64_t paymentNumber;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    paymentNumber = ++stats_.payCalls;
+    latency = drawLatency();
+    state = drawOutcome();
+    waitingFirst = std::uniform_real_distribution<double>(0, 1)(random_) < script_.waitingFirstRatio;
+  }
+
+  PaymentOutcome outcome;
+  outcome.state = state;
+  outcome.localSessionId = "scripted-" + std::to_string(paymentNumber);
+  outcome.category = categoryFor(state);
+  if (state == PaymentState::Error) {
+    outcome.info = "Scripted error for " + request.bankInvoiceId;
+  }
+  if (!waitingFirst || state == PaymentState::Waiting) {
+    schedule(latency, [callback = std::move(callback), outcome] { callback(outcome); });
+    return;
+  }
+  PaymentOutcome waiting = outcome;
+  waiting.state = PaymentState::Waiting;
+  waiting.info.clear();
+  waiting.category = ErrorCategory::None;
+  schedule(latency, [callback, waiting] { callback(waiting); });
+  schedule(latency + script_.waitingToFinal, [callback = std::move(callback), outcome] { callback(outcome); });
+}
+
+void ScriptedPlatformBackend::flush() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TimePoint now = std::chrono::steady_clock::now();
+    std::vector<Task> flushed;
+    flushed.reserve(tasks_.size());
+    while (!tasks_.empty()) {
+      flushed.push_back(std::move(const_cast<Task &>(tasks_.top())));
+      tasks_.pop();
+    }
+    for (auto &task : flushed) {
+      task.due = std::min(task.due, now);
+      tasks_.push(std::move(task));
+    }
+  }
+  wakeUp_.notify_one();
+}
+
+bool ScriptedPlatformBackend::drain(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return idle_.wait_for(lock, timeout, [this] { return tasks_.empty() && !running_; });
+}
+
+size_t ScriptedPlatformBackend::pendingCallbacks() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tasks_.size() + (running_ ? 1 : 0);
+}
+
+ScriptedPlatformBackend::Stats ScriptedPlatformBackend::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void ScriptedPlatformBackend::schedule(std::chrono::microseconds delay, std::function<void()> run) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push({std::chrono::steady_clock::now() + delay, nextSequence_++, std::move(run)});
+  }
+  wakeUp_.notify_one();
+}
+
+std::chrono::microseconds ScriptedPlatformBackend::drawLatency() {
+  if (script_.maxPayLatency <= script_.minPayLatency) {
+    return script_.minPayLatency;
+  }
+  std::uniform_int_distribution<int64_t> distribution(script_.minPayLatency.count(), script_.maxPayLatency.count());
+  return std::chrono::microseconds(distribution(random_));
+}
+
+PaymentState ScriptedPlatformBackend::drawOutcome() {
+  double total = 0;
+  for (const auto &outcome : script_.outcomes) {
+    total += outcome.second;
+  }
+  double draw = std::uniform_real_distribution<double>(0, total)(random_);
+  for (const auto &outcome : script_.outcomes) {
+    if (draw < outcome.second) {
+      return outcome.first;
+    }
+    draw -= outcome.second;
+  }
+  return script_.outcomes.empty() ? PaymentState::Success : script_.outcomes.back().first;
+}
+
+void ScriptedPlatformBackend::runLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (stopping_) {
+      return;
+    }
+    if (tasks_.empty()) {
+      idle_.notify_all();
+      wakeUp_.wait_for(lock, kIdleWakeUp);
+      continue;
+    }
+    TimePoint due = tasks_.top().due;
+    if (std::chrono::steady_clock::now() < due) {
+      wakeUp_.wait_until(lock, due);
+      continue;
+    }
+    // priority_queue::top is const, the task is moved out before popping.
+    Task task = std::move(const_cast<Task &>(tasks_.top()));
+    tasks_.pop();
+    running_ = true;
+    lock.unlock();
+    task.run();
+    lock.lock();
+    running_ = false;
+    ++stats_.callbacksFired;
+  }
+}
+
+} // namespace spaybridge
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "SPayBridge.h"
+
+namespace spaybridge {
+
+// How the scripted backend answers. Latencies are drawn uniformly from
+// [min, max]; the final state of a payment is drawn from `outcomes` by weight.
+struct BackendScript {
+  std::chrono::microseconds setupLatency{0};
+  std::optional<std::string> setupError;
+  bool ready = true;
+
+  std::chrono::microseconds minPayLatency{0};
+  std::chrono::microseconds maxPayLatency{0};
+  std::vector<std::pair<PaymentState, double>> outcomes{{PaymentState::Success, 1.0}};
+
+  // Share of payments that report Waiting (Android's Processing) first and
+  // their final state `waitingToFinal` later.
+  double waitingFirstRatio = 0;
+  std::chrono::microseconds waitingToFinal{0};
+
+  // Same seed, same sequence of latencies and outcomes.
+  uint64_t seed = 1;
+};
+
+// Stand-in for the SDK that needs no bank: answers calls on its own thread
+// after the scripted latency, like the real SDKs answer on the main thread.
+class ScriptedPlatformBackend : public PlatformBackend {
+public:
+  struct Stats {
+    uint64_t setupCalls = 0;
+    uint64_t payCalls = 0;
+    uint64_t callbacksFired = 0;
+  };
+
+  explicit ScriptedPlatformBackend(BackendScript script = {});
+  ~ScriptedPlatformBackend() override;
+
+  void setup(const SetupConfig &config, SetupCallback callback) override;
+  bool isReady() override;
+  void pay(PayMethod method, const PaymentRequest &request, PaymentCallback callback) override;
+
+  // Makes every scheduled callback due now, keeping their order, e.g. before
+  // the backend is released with payments still waiting for an answer.
+  void flush();
+
+  // Blocks until every scheduled callback has fired; false if that took
+  // longer than `timeout`.
+  bool drain(std::chrono::milliseconds timeout = std::chrono::seconds(10));
+  size_t pendingCallbacks() const;
+  Stats stats() const;
+
+private:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  struct Task {
+    TimePoint due;
+    uint64_t sequence;
+    std::function<void()> run;
+
+    bool operator>(const Task &other) const {
+      return due != other.due ? due > other.due : sequence > other.sequence;
+    }
+  };
+
+  void schedule(std::chrono::microseconds delay, std::function<void()> run);
+  std::chrono::microseconds drawLatency();
+  PaymentState drawOutcome();
+  void runLoop();
+
+  const BackendScript script_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wakeUp_;
+  std::condition_variable idle_;
+  std::priority_queue<Task, std::vector<Task>, std::greater<>> tasks_;
+  bool running_ = false;
+  bool stopping_ = false;
+  uint64_t nextSequence_ = 0;
+  std::mt19937_64 random_;
+  Stats stats_;
+  std::thread worker_;
+};
+
+} // namespace spaybridge
@@ -0,0 +1,198 @@
+// Micro-benchmarks of the payment bridge core against an in-process backend
+// that answers like the SDK would, without a bank. Prints one JSON document:
+//
+//   spaybridge_bench [--iterations N] > results.json
+//
+// `allocsPerOp` counts global operator new calls, so results are comparable
+// between releases regardless of the allocator.
+
+#include <SPayBridge.h>
+#include <LatencyHistogram.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> gAllocations{0};
+
+} // namespace
+
+void *operator new(std::size_t size) {
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace spaybridge;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Answers setup immediately and keeps payments pending until the benchmark
+// completes them, so callback delivery can be timed on its own.
+class BenchBackend : public PlatformBackend {
+public:
+  void setup(const SetupConfig &, SetupCallback callback) override { callback(std::nullopt); }
+
+  bool isReady() override { return true; }
+
+  void pay(PayMethod, const PaymentRequest &, PaymentCallback callback) override {
+    if (immediate) {
+      PaymentOutcome outcome;
+      outcome.state = PaymentState::Success;
+      callback(outcome);
+    } else {
+      pending.push_back(std::move(callback));
+    }
+  }
+
+  bool immediate = true;
+  std::vector<PaymentCallback> pending;
+};
+
+struct Result {
+  std::string name;
+  uint64_t iterations = 0;
+  double nsPerOp = 0;
+  double allocsPerOp = 0;
+  double p50Ns = -1;
+  double p99Ns = -1;
+};
+
+Result measure(const char *name, uint64_t iterations, const std::function<void(uint64_t)> &body) {
+  uint64_t allocationsBefore = gAllocations.load();
+  auto start = Clock::now();
+  for (uint64_t i = 0; i < iterations; ++i) {
+    body(i);
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  Result result;
+  result.name = name;
+  result.iterations = iterations;
+  result.nsPerOp = elapsed / iterations;
+  result.allocsPerOp = static_cast<double>(gAllocations.load() - allocationsBefore) / iterations;
+  return result;
+}
+
+PaymentRequest requestFor(uint64_t i) {
+  PaymentRequest request;
+  request.merchantLogin = "merchant";
+  request.bankInvoiceId = "invoice-" + std::to_string(i);
+  request.orderNumber = "412";
+  return request;
+}
+
+double percentile(std::vector<double> &samples, double q) {
+  std::sort(samples.begin(), samples.end());
+  return samples[static_cast<size_t>(q * (samples.size() - 1))];
+}
+
+void printJson(const std::vector<Result> &results) {
+  std::printf("{\"suite\":\"spaybridge\",\"results\":[");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result &r = results[i];
+    std::printf("%s{\"name\":\"%s\",\"iterations\":%llu,\"nsPerOp\":%.1f,\"opsPerSec\":%.0f,\"allocsPerOp\":%.2f",
+                i ? "," : "", r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.nsPerOp,
+                1e9 / r.nsPerOp, r.allocsPerOp);
+    if (r.p50Ns >= 0) {
+      std::printf(",\"p50Ns\":%.1f,\"p99Ns\":%.1f", r.p50Ns, r.p99Ns);
+    }
+    std::printf("}");
+  }
+  std::printf("]}\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  uint64_t iterations = 10000;
+  for (int i = 1; i + 1 < argc; ++i) {
+    if (std::strcmp(argv[i], "--iterations") == 0) {
+      iterations = std::strtoull(argv[i + 1], nullptr, 10);
+    }
+  }
+  iterations = std::max<uint64_t>(iterations, 1);
+
+  std::vector<Result> results;
+  auto backend = std::make_shared<BenchBackend>();
+  auto bridge = std::make_shared<SPayBridge>(backend);
+  SetupConfig config;
+  bridge->setup(config, [](const std::optional<std::string> &) {});
+  bridge->refreshReadiness();
+
+  results.push_back(measure("setup.repeated", iterations, [&](uint64_t) {
+    bridge->setup(config, [](const std::optional<std::string> &) {});
+  }));
+
+  results.push_back(measure("isReady.cached", iterations, [&](uint64_t) {
+    volatile bool ready = bridge->isReady().value_or(false);
+    (void)ready;
+  }));
+
+  std::vector<PaymentRequest> requests;
+  requests.reserve(iterations);
+  for (uint64_t i = 0; i < iterations; ++i) {
+    requests.push_back(requestFor(i));
+  }
+
+  results.push_back(measure("pay.immediate", iterations, [&](uint64_t i) {
+    bridge->pay(PayMethod::BankInvoiceId, requests[i], [](const PaymentOutcome &) {});
+  }));
+
+  // Two callers for the same invoice share one backend call, which reports
+  // waiting and then success.
+  backend->immediate = false;
+  results.push_back(measure("pay.coalescedWaitingThenFinal", iterations, [&](uint64_t i) {
+    bridge->pay(PayMethod::PartPay, requests[i], [](const PaymentOutcome &) {});
+    bridge->pay(PayMethod::PartPay, requests[i], [](const PaymentOutcome &) {});
+    PaymentCallback callback = std::move(backend->pending.back());
+    backend->pending.pop_back();
+    PaymentOutcome outcome;
+    outcome.state = PaymentState::Waiting;
+    callback(outcome);
+    outcome.state = PaymentState::Success;
+    callback(outcome);
+  }));
+
+  // Time from the SDK reporting an outcome to the caller's callback running.
+  std::vector<double> latencies;
+  latencies.reserve(iterations);
+  Clock::time_point reportedAt;
+  for (uint64_t i = 0; i < iterations; ++i) {
+    bridge->pay(PayMethod::BankInvoiceId, requests[i], [&](const PaymentOutcome &) {
+      latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - reportedAt).count());
+    });
+  }
+  Result delivery = measure("pay.callbackDelivery", iterations, [&](uint64_t i) {
+    PaymentOutcome outcome;
+    outcome.state = PaymentState::Success;
+    reportedAt = Clock::now();
+    backend->pending[i](outcome);
+  });
+  delivery.p50Ns = percentile(latencies, 0.5);
+  delivery.p99Ns = percentile(latencies, 0.99);
+  results.push_back(delivery);
+  backend->pending.clear();
+
+  LatencyRecorder recorder;
+  results.push_back(measure("latency.record", iterations, [&](uint64_t i) {
+    recorder.record(Operation::PayBankInvoiceId, PaymentState::Success, std::chrono::microseconds(i));
+  }));
+
+  printJson(results);
+  return bridge->inFlightPayments() == 0 ? 0 : 1;
+}
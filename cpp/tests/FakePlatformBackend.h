@@ -0,0 +1,39 @@
+#pragma once
+
+#include <SPayBridge.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spaybridge::testing {
+
+// Records every call and lets the test decide when and how the SDK answers.
+class FakePlatformBackend : public PlatformBackend {
+public:
+  struct PayCall {
+    PayMethod method;
+    PaymentRequest request;
+    PaymentCallback callback;
+  };
+
+  void setup(const SetupConfig &config, SetupCallback callback) override {
+    setupCalls.emplace_back(config, std::move(callback));
+  }
+
+  bool isReady() override {
+    ++isReadyCalls;
+    return ready;
+  }
+
+  void pay(PayMethod method, const PaymentRequest &request, PaymentCallback callback) override {
+    payCalls.push_back({method, request, std::move(callback)});
+  }
+
+  bool ready = false;
+  int isReadyCalls = 0;
+  std::vector<std::pair<SetupConfig, SetupCallback>> setupCalls;
+  std::vector<PayCall> payCalls;
+};
+
+} // namespace spaybridge::testing
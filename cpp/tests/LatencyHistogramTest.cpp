@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "LatencyHistogram.h"
+
+using namespace spaybridge;
+
+TEST(LatencyHistogramTest, BucketsAreContiguousAndOrdered) {
+  for (size_t bucket = 1; bucket < LatencyHistogram::kBucketCount; ++bucket) {
+    uint64_t low = LatencyHistogram::lowerBound(bucket);
+    EXPECT_GT(low, LatencyHistogram::lowerBound(bucket - 1));
+    EXPECT_EQ(LatencyHistogram::bucketFor(low), bucket);
+    EXPECT_EQ(LatencyHistogram::bucketFor(low - 1), bucket - 1);
+  }
+  EXPECT_EQ(LatencyHistogram::bucketFor(UINT64_MAX), LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesStayWithinBucketPrecision) {
+  LatencyHistogram histogram;
+  for (uint64_t micros = 1; micros <= 1000; ++micros) {
+    histogram.record(micros * 1000);
+  }
+  EXPECT_EQ(histogram.count(), 1000u);
+  EXPECT_EQ(histogram.min(), 1000u);
+  EXPECT_EQ(histogram.max(), 1000000u);
+  EXPECT_NEAR(static_cast<double>(histogram.percentile(0.5)), 500000, 500000 * 0.125);
+  EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99)), 990000, 990000 * 0.125);
+  EXPECT_EQ(histogram.percentile(1.0), 1000000u);
+}
+
+TEST(LatencyHistogramTest, SingleValueReportsItselfForEveryPercentile) {
+  LatencyHistogram histogram;
+  histogram.record(1234);
+  EXPECT_EQ(histogram.percentile(0), 1234u);
+  EXPECT_EQ(histogram.percentile(0.5), 1234u);
+  EXPECT_EQ(histogram.percentile(0.99), 1234u);
+}
+
+TEST(LatencyHistogramTest, DrainNamesByOutcomeAndResets) {
+  LatencyRecorder recorder;
+  recorder.record(Operation::IsReady, PaymentState::Success, std::chrono::microseconds(5));
+  recorder.record(operationFor(PayMethod::PartPay), PaymentState::Waiting, std::chrono::milliseconds(20));
+  recorder.record(operationFor(PayMethod::PartPay), PaymentState::Waiting, std::chrono::milliseconds(40));
+
+  auto summaries = recorder.drain();
+  ASSERT_EQ(summaries.size(), 2u);
+  EXPECT_EQ(summaries[0].name, "isReadyForSPay");
+  EXPECT_EQ(summaries[0].count, 1u);
+  EXPECT_EQ(summaries[1].name, "payWithPartPay.waiting");
+  EXPECT_EQ(summaries[1].count, 2u);
+  EXPECT_EQ(summaries[1].minMicros, 20000u);
+  EXPECT_EQ(summaries[1].maxMicros, 40000u);
+
+  EXPECT_TRUE(recorder.drain().empty());
+  EXPECT_EQ(toJson({}), "[]");
+}
+
+TEST(LatencyHistogramTest, JsonWritesTheMeanInFixedNotation) {
+  HistogramSummary summary;
+  summary.name = "pay.success";
+  summary.count = 2;
+  summary.minMicros = 12000000;
+  summary.maxMicros = 12345679;
+  summary.meanMicros = 12172839.5;
+  EXPECT_EQ(toJson({summary}), "[{\"name\":\"pay.success\",\"count\":2,\"minMicros\":12000000,\"maxMicros\":12345679,"
+                               "\"meanMicros\":12172839.5,\"p50Micros\":0,\"p90Micros\":0,\"p99Micros\":0}]");
+}
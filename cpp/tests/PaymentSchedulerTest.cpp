@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "PaymentScheduler.h"
+
+using namespace spaybridge;
+
+namespace {
+
+class PaymentSchedulerTest : public ::testing::Test {
+protected:
+  PaymentScheduler scheduler;
+  std::vector<std::string> events;
+
+  void submit(const std::string &id, SchedulingPolicy policy = SchedulingPolicy::Enqueue, int priority = 0) {
+    PaymentScheduler::Job job;
+    job.id = id;
+    job.priority = priority;
+    job.start = [this, id] { events.push_back("start:" + id); };
+    job.drop = [this, id](DropReason reason) { events.push_back(std::string(toString(reason)) + ":" + id); };
+    scheduler.submit(policy, std::move(job));
+  }
+};
+
+} // namespace
+
+TEST_F(PaymentSchedulerTest, EnqueuedPaymentsStartOneAfterAnother) {
+  submit("a");
+  submit("b");
+  EXPECT_EQ(events, (std::vector<std::string>{"start:a"}));
+  EXPECT_EQ(scheduler.waiting(), 1u);
+
+  scheduler.finish("b");
+  EXPECT_EQ(events.size(), 1u);
+
+  scheduler.finish("a");
+  EXPECT_EQ(events, (std::vector<std::string>{"start:a", "start:b"}));
+  scheduler.finish("b");
+  EXPECT_FALSE(scheduler.active().has_value());
+}
+
+TEST_F(PaymentSchedulerTest, HigherPriorityStartsFirstAndTiesKeepOrder) {
+  submit("active");
+  submit("low", SchedulingPolicy::Enqueue, 0);
+  submit("high", SchedulingPolicy::Enqueue, 5);
+  submit("low2", SchedulingPolicy::Enqueue, 0);
+
+  scheduler.finish("active");
+  scheduler.finish("high");
+  scheduler.finish("low");
+  EXPECT_EQ(events, (std::vector<std::string>{"start:active", "start:high", "start:low", "start:low2"}));
+}
+
+TEST_F(PaymentSchedulerTest, RejectDropsOnlyWhileBusy) {
+  submit("a", SchedulingPolicy::Reject);
+  submit("b", SchedulingPolicy::Reject);
+  scheduler.finish("a");
+  submit("c", SchedulingPolicy::Reject);
+  EXPECT_EQ(events, (std::vector<std::string>{"start:a", "rejected:b", "start:c"}));
+}
+
+TEST_F(PaymentSchedulerTest, ReplaceDropsWaitingPaymentsButNotTheActiveOne) {
+  submit("a");
+  submit("b");
+  submit("c");
+  submit("d", SchedulingPolicy::Replace);
+  EXPECT_EQ(events, (std::vector<std::string>{"start:a", "replaced:b", "replaced:c"}));
+
+  scheduler.finish("a");
+  EXPECT_EQ(events.back(), "start:d");
+}
+
+TEST_F(PaymentSchedulerTest, CancelDropsWaitingPaymentsOnly) {
+  submit("a");
+  submit("b");
+  EXPECT_FALSE(scheduler.cancel("a"));
+  EXPECT_TRUE(scheduler.cancel("b"));
+  EXPECT_FALSE(scheduler.cancel("b"));
+
+  scheduler.finish("a");
+  EXPECT_EQ(events, (std::vector<std::string>{"start:a", "cancelled:b"}));
+  EXPECT_FALSE(scheduler.active().has_value());
+}
+
+TEST_F(PaymentSchedulerTest, JobFinishingSynchronouslyStartsTheNext) {
+  PaymentScheduler::Job failing;
+  failing.id = "failing";
+  failing.start = [this] {
+    events.push_back("start:failing");
+    scheduler.finish("failing");
+  };
+  failing.drop = [](DropReason) {};
+  submit("a");
+  scheduler.submit(SchedulingPolicy::Enqueue, std::move(failing));
+  submit("b");
+
+  scheduler.finish("a");
+  EXPECT_EQ(events, (std::vector<std::string>{"start:a", "start:failing", "start:b"}));
+}
+
+TEST_F(PaymentSchedulerTest, ReleaseFreesAnActiveJobThatNeverFinishes) {
+  submit("a");
+  submit("b");
+  // "a" never reports back; its caller gives up on it.
+  EXPECT_TRUE(scheduler.release("a"));
+  EXPECT_EQ(scheduler.active(), "b");
+  scheduler.finish("a");
+  EXPECT_EQ(scheduler.active(), "b");
+
+  submit("c");
+  EXPECT_TRUE(scheduler.release("c"));
+  EXPECT_FALSE(scheduler.release("c"));
+  EXPECT_EQ(events, (std::vector<std::string>{"start:a", "start:b", "cancelled:c"}));
+}
+
+TEST_F(PaymentSchedulerTest, JobActiveForTooLongIsReleasedByTheNextSubmit) {
+  PaymentScheduler stale(std::chrono::milliseconds(0));
+  auto submitTo = [&](const std::string &id) {
+    PaymentScheduler::Job job;
+    job.id = id;
+    job.start = [this, id] { events.push_back("start:" + id); };
+    job.drop = [this, id](DropReason reason) { events.push_back(std::string(toString(reason)) + ":" + id); };
+    stale.submit(SchedulingPolicy::Reject, std::move(job));
+  };
+  submitTo("a");
+  submitTo("b");
+  EXPECT_EQ(events, (std::vector<std::string>{"start:a", "start:b"}));
+  EXPECT_EQ(stale.active(), "b");
+}
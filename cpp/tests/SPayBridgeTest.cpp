@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+
+#include "FakePlatformBackend.h"
+#include "PaymentScheduler.h"
+
+using namespace spaybridge;
+using spaybridge::testing::FakePlatformBackend;
+
+namespace {
+
+PaymentRequest requestFor(const std::string &bankInvoiceId) {
+  PaymentRequest request;
+  request.merchantLogin = "merchant";
+  request.bankInvoiceId = bankInvoiceId;
+  request.orderNumber = "412";
+  return request;
+}
+
+class SPayBridgeTest : public ::testing::Test {
+protected:
+  std::shared_ptr<FakePlatformBackend> backend = std::make_shared<FakePlatformBackend>();
+  std::shared_ptr<SPayBridge> bridge = std::make_shared<SPayBridge>(backend);
+};
+
+} // namespace
+
+TEST_F(SPayBridgeTest, ConcurrentSetupWithSameConfigSharesOneInit) {
+  SetupConfig config;
+  config.bnplPlan = true;
+  int answered = 0;
+  bridge->setup(config, [&](const std::optional<std::string> &error) { answered += error ? 0 : 1; });
+  bridge->setup(config, [&](const std::optional<std::string> &error) { answered += error ? 0 : 1; });
+  ASSERT_EQ(backend->setupCalls.size(), 1u);
+
+  backend->setupCalls[0].second(std::nullopt);
+  EXPECT_EQ(answered, 2);
+
+  bridge->setup(config, [&](const std::optional<std::string> &error) { answered += error ? 0 : 1; });
+  EXPECT_EQ(answered, 3);
+  EXPECT_EQ(backend->setupCalls.size(), 1u);
+}
+
+TEST_F(SPayBridgeTest, ChangedConfigReinitialises) {
+  SetupConfig config;
+  bridge->setup(config, [](const std::optional<std::string> &) {});
+  backend->setupCalls[0].second(std::nullopt);
+
+  config.environment = Environment::SandboxRealBankApp;
+  bridge->setup(config, [](const std::optional<std::string> &) {});
+  EXPECT_EQ(backend->setupCalls.size(), 2u);
+}
+
+TEST_F(SPayBridgeTest, FailedSetupIsRetried) {
+  SetupConfig config;
+  std::optional<std::string> reported;
+  bridge->setup(config, [&](const std::optional<std::string> &error) { reported = error; });
+  backend->setupCalls[0].second(std::string("config error"));
+  EXPECT_EQ(reported, std::optional<std::string>("config error"));
+
+  bridge->setup(config, [](const std::optional<std::string> &) {});
+  EXPECT_EQ(backend->setupCalls.size(), 2u);
+}
+
+TEST_F(SPayBridgeTest, ReadinessIsCachedAndPushedOnChange) {
+  std::vector<bool> pushed;
+  bridge->setReadinessListener([&](bool isReady) { pushed.push_back(isReady); });
+  EXPECT_FALSE(bridge->isReady().has_value());
+
+  backend->ready = true;
+  EXPECT_TRUE(bridge->refreshReadiness());
+  EXPECT_EQ(bridge->isReady(), std::optional<bool>(true));
+  EXPECT_EQ(backend->isReadyCalls, 1);
+
+  bridge->updateReadiness(true);
+  bridge->updateReadiness(false);
+  EXPECT_EQ(pushed, (std::vector<bool>{true, false}));
+  EXPECT_EQ(bridge->isReady(), std::optional<bool>(false));
+}
+
+TEST_F(SPayBridgeTest, SuccessfulSetupRefreshesReadiness) {
+  backend->ready = true;
+  bridge->setup(SetupConfig(), [](const std::optional<std::string> &) {});
+  backend->setupCalls[0].second(std::nullopt);
+  EXPECT_EQ(bridge->isReady(), std::optional<bool>(true));
+}
+
+TEST_F(SPayBridgeTest, ConcurrentPaymentsForSameInvoiceAreCoalesced) {
+  std::vector<PaymentState> first;
+  std::vector<PaymentState> second;
+  bridge->pay(PayMethod::BankInvoiceId, requestFor("invoice"),
+             [&](const PaymentOutcome &outcome) { first.push_back(outcome.state); });
+  bridge->pay(PayMethod::BankInvoiceId, requestFor("invoice"),
+             [&](const PaymentOutcome &outcome) { second.push_back(outcome.state); });
+  bridge->pay(PayMethod::PartPay, requestFor("other"), [](const PaymentOutcome &) {});
+  ASSERT_EQ(backend->payCalls.size(), 2u);
+  EXPECT_EQ(bridge->inFlightPayments(), 2u);
+
+  std::vector<std::string> later;
+  bridge->setPaymentStateListener([&](PayMethod method, const PaymentRequest &request, const PaymentOutcome &outcome) {
+    later.push_back(std::string(toString(method)) + ":" + request.bankInvoiceId + ":" + toString(outcome.state));
+  });
+  backend->payCalls[0].callback({PaymentState::Waiting, "", "local"});
+  EXPECT_EQ(bridge->inFlightPayments(), 1u);
+  backend->payCalls[0].callback({PaymentState::Success, "", "local"});
+  EXPECT_EQ(bridge->inFlightPayments(), 1u);
+
+  const std::vector<PaymentState> expected{PaymentState::Waiting};
+  EXPECT_EQ(first, expected);
+  EXPECT_EQ(second, expected);
+  EXPECT_EQ(later, std::vector<std::string>{"payWithBankInvoiceId:invoice:success"});
+
+  bridge->pay(PayMethod::BankInvoiceId, requestFor("invoice"), [](const PaymentOutcome &) {});
+  EXPECT_EQ(backend->payCalls.size(), 3u);
+}
+
+TEST_F(SPayBridgeTest, WaitingFollowedBySilenceDoesNotBlockTheNextCall) {
+  std::vector<PaymentState> first;
+  std::vector<PaymentState> second;
+  bridge->pay(PayMethod::BankInvoiceId, requestFor("invoice"),
+             [&](const PaymentOutcome &outcome) { first.push_back(outcome.state); });
+  backend->payCalls[0].callback({PaymentState::Waiting, "", ""});
+  EXPECT_EQ(bridge->inFlightPayments(), 0u);
+
+  // The SDK never reports the first payment again.
+  bridge->pay(PayMethod::BankInvoiceId, requestFor("invoice"),
+             [&](const PaymentOutcome &outcome) { second.push_back(outcome.state); });
+  ASSERT_EQ(backend->payCalls.size(), 2u);
+  backend->payCalls[1].callback({PaymentState::Success, "", ""});
+
+  EXPECT_EQ(first, std::vector<PaymentState>{PaymentState::Waiting});
+  EXPECT_EQ(second, std::vector<PaymentState>{PaymentState::Success});
+  EXPECT_EQ(bridge->inFlightPayments(), 0u);
+}
+
+TEST_F(SPayBridgeTest, PaymentsWithDifferentMethodsAreNotCoalesced) {
+  std::vector<PaymentState> whole;
+  std::vector<PaymentState> parts;
+  bridge->pay(PayMethod::BankInvoiceId, requestFor("invoice"),
+             [&](const PaymentOutcome &outcome) { whole.push_back(outcome.state); });
+  bridge->pay(PayMethod::PartPay, requestFor("invoice"),
+             [&](const PaymentOutcome &outcome) { parts.push_back(outcome.state); });
+  ASSERT_EQ(backend->payCalls.size(), 2u);
+  EXPECT_EQ(backend->payCalls[1].method, PayMethod::PartPay);
+
+  backend->payCalls[1].callback({PaymentState::Cancel, "", ""});
+  EXPECT_TRUE(whole.empty());
+  EXPECT_EQ(parts, std::vector<PaymentState>{PaymentState::Cancel});
+}
+
+TEST_F(SPayBridgeTest, LateCallbacksAfterFinalStateAreIgnored) {
+  int calls = 0;
+  std::vector<std::string> later;
+  bridge->setPaymentStateListener(
+      [&](PayMethod, const PaymentRequest &, const PaymentOutcome &outcome) { later.push_back(outcome.info); });
+  bridge->pay(PayMethod::WithoutRefresh, requestFor("invoice"), [&](const PaymentOutcome &) { ++calls; });
+  backend->payCalls[0].callback({PaymentState::Cancel, "", ""});
+  backend->payCalls[0].callback({PaymentState::Error, "late", ""});
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(later, std::vector<std::string>{"late"});
+}
+
+TEST(SPayBridgeSchedulingTest, PaymentsWaitForTheSheetOnScreen) {
+  auto backend = std::make_shared<FakePlatformBackend>();
+  auto scheduler = std::make_shared<PaymentScheduler>();
+  auto bridge = std::make_shared<SPayBridge>(backend, scheduler);
+  std::vector<std::string> settled;
+  auto record = [&](const std::string &id) {
+    return [&, id](const PaymentOutcome &outcome) { settled.push_back(id + ":" + toString(outcome.state)); };
+  };
+
+  bridge->pay(PayMethod::BankInvoiceId, requestFor("first"), record("first"));
+  bridge->pay(PayMethod::BankInvoiceId, requestFor("second"), record("second"));
+  ASSERT_EQ(backend->payCalls.size(), 1u);
+  EXPECT_EQ(scheduler->waiting(), 1u);
+
+  PaymentOutcome outcome;
+  outcome.state = PaymentState::Waiting;
+  backend->payCalls[0].callback(outcome);
+  ASSERT_EQ(backend->payCalls.size(), 2u);
+  EXPECT_EQ(backend->payCalls[1].request.bankInvoiceId, "second");
+
+  outcome.state = PaymentState::Success;
+  backend->payCalls[0].callback(outcome);
+  backend->payCalls[1].callback(outcome);
+  EXPECT_EQ(settled, (std::vector<std::string>{"first:waiting", "second:success"}));
+  EXPECT_EQ(bridge->inFlightPayments(), 0u);
+  EXPECT_FALSE(scheduler->active().has_value());
+}
+
+TEST(SPayBridgeSchedulingTest, DroppedPaymentsCarryTheirCategory) {
+  auto backend = std::make_shared<FakePlatformBackend>();
+  auto scheduler = std::make_shared<PaymentScheduler>();
+  auto bridge = std::make_shared<SPayBridge>(backend, scheduler);
+  PaymentOutcome rejected;
+  bridge->pay(PayMethod::BankInvoiceId, requestFor("first"), [](const PaymentOutcome &) {});
+  bridge->pay(PayMethod::BankInvoiceId, requestFor("second"), [&](const PaymentOutcome &outcome) { rejected = outcome; });
+  scheduler->submit(SchedulingPolicy::Replace, {"newest", 0, [] {}, [](DropReason) {}});
+
+  EXPECT_EQ(rejected.state, PaymentState::Error);
+  EXPECT_EQ(rejected.category, ErrorCategory::Scheduling);
+  EXPECT_EQ(categoryFor(PaymentState::Error), ErrorCategory::Sdk);
+  EXPECT_EQ(categoryFor(PaymentState::Cancel), ErrorCategory::None);
+}
+
+TEST(SPayBridgeSchedulingTest, ReleasedBridgeStillFreesTheSchedulerSlot) {
+  auto backend = std::make_shared<FakePlatformBackend>();
+  auto scheduler = std::make_shared<PaymentScheduler>();
+  auto released = std::make_shared<SPayBridge>(backend, scheduler);
+  auto current = std::make_shared<SPayBridge>(backend, scheduler);
+  int reported = 0;
+  released->pay(PayMethod::BankInvoiceId, requestFor("active"), [&](const PaymentOutcome &) { ++reported; });
+  released->pay(PayMethod::BankInvoiceId, requestFor("queued"), [&](const PaymentOutcome &) { ++reported; });
+  current->pay(PayMethod::BankInvoiceId, requestFor("next"), [&](const PaymentOutcome &) { ++reported; });
+  ASSERT_EQ(backend->payCalls.size(), 1u);
+  released.reset();
+
+  // The active sheet keeps the slot until it reports; the released bridge's
+  // queued payment is skipped instead of reaching the backend.
+  backend->payCalls[0].callback({PaymentState::Success, "", ""});
+  ASSERT_EQ(backend->payCalls.size(), 2u);
+  EXPECT_EQ(backend->payCalls[1].request.bankInvoiceId, "next");
+  EXPECT_EQ(reported, 0);
+
+  backend->payCalls[1].callback({PaymentState::Success, "", ""});
+  EXPECT_EQ(reported, 1);
+  EXPECT_FALSE(scheduler->active().has_value());
+}
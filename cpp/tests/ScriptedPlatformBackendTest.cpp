@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <map>
+#include <thread>
+
+#include "ScriptedPlatformBackend.h"
+
+using namespace spaybridge;
+
+namespace {
+
+PaymentRequest requestFor(const std::string &bankInvoiceId) {
+  PaymentRequest request;
+  request.merchantLogin = "merchant";
+  request.bankInvoiceId = bankInvoiceId;
+  request.orderNumber = "412";
+  return request;
+}
+
+} // namespace
+
+TEST(ScriptedPlatformBackendTest, OutcomesFollowTheScriptedDistribution) {
+  BackendScript script;
+  script.outcomes = {{PaymentState::Success, 0.7}, {PaymentState::Cancel, 0.2}, {PaymentState::Error, 0.1}};
+  ScriptedPlatformBackend backend(script);
+
+  std::mutex mutex;
+  std::map<PaymentState, int> counts;
+  constexpr int kPayments = 5000;
+  for (int i = 0; i < kPayments; ++i) {
+    backend.pay(PayMethod::BankInvoiceId, requestFor(std::to_string(i)), [&](const PaymentOutcome &outcome) {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++counts[outcome.state];
+    });
+  }
+  ASSERT_TRUE(backend.drain());
+
+  EXPECT_NEAR(counts[PaymentState::Success] / double(kPayments), 0.7, 0.03);
+  EXPECT_NEAR(counts[PaymentState::Cancel] / double(kPayments), 0.2, 0.03);
+  EXPECT_NEAR(counts[PaymentState::Error] / double(kPayments), 0.1, 0.03);
+  EXPECT_EQ(backend.stats().callbacksFired, static_cast<uint64_t>(kPayments));
+}
+
+TEST(ScriptedPlatformBackendTest, WaitingIsReportedBeforeTheFinalState) {
+  BackendScript script;
+  script.waitingFirstRatio = 1;
+  script.minPayLatency = script.maxPayLatency = std::chrono::microseconds(200);
+  script.waitingToFinal = std::chrono::milliseconds(2);
+  ScriptedPlatformBackend backend(script);
+
+  std::vector<PaymentState> states;
+  backend.pay(PayMethod::PartPay, requestFor("1"), [&](const PaymentOutcome &outcome) {
+    states.push_back(outcome.state);
+  });
+  ASSERT_TRUE(backend.drain());
+
+  ASSERT_EQ(states.size(), 2u);
+  EXPECT_EQ(states[0], PaymentState::Waiting);
+  EXPECT_EQ(states[1], PaymentState::Success);
+}
+
+TEST(ScriptedPlatformBackendTest, BridgeSettlesEveryCallerUnderConcurrentLoad) {
+  BackendScript script;
+  script.maxPayLatency = std::chrono::microseconds(300);
+  script.waitingFirstRatio = 0.3;
+  script.waitingToFinal = std::chrono::microseconds(100);
+  script.outcomes = {{PaymentState::Success, 0.8}, {PaymentState::Cancel, 0.2}};
+  auto backend = std::make_shared<ScriptedPlatformBackend>(script);
+  auto bridge = std::make_shared<SPayBridge>(backend);
+
+  constexpr int kThreads = 8;
+  constexpr int kPaymentsPerThread = 400;
+  std::atomic<int> settled{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kPaymentsPerThread; ++i) {
+        // Invoice ids repeat across threads, so calls both coalesce and race.
+        bridge->pay(PayMethod::BankInvoiceId, requestFor(std::to_string((t * 7 + i) % 97)),
+                   [&](const PaymentOutcome &) { ++settled; });
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(backend->drain());
+
+  EXPECT_EQ(settled.load(), kThreads * kPaymentsPerThread);
+  EXPECT_EQ(bridge->inFlightPayments(), 0u);
+  EXPECT_LE(backend->stats().payCalls, static_cast<uint64_t>(kThreads * kPaymentsPerThread));
+}
+
+TEST(ScriptedPlatformBackendTest, FlushAnswersPendingPaymentsInOrder) {
+  BackendScript script;
+  script.waitingFirstRatio = 1;
+  script.minPayLatency = script.maxPayLatency = std::chrono::seconds(30);
+  script.waitingToFinal = std::chrono::seconds(30);
+  ScriptedPlatformBackend backend(script);
+
+  std::mutex mutex;
+  std::vector<PaymentState> states;
+  backend.pay(PayMethod::BankInvoiceId, requestFor("1"), [&](const PaymentOutcome &outcome) {
+    std::lock_guard<std::mutex> lock(mutex);
+    states.push_back(outcome.state);
+  });
+  backend.flush();
+  ASSERT_TRUE(backend.drain(std::chrono::seconds(1)));
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(states.size(), 2u);
+  EXPECT_EQ(states[0], PaymentState::Waiting);
+  EXPECT_EQ(states[1], PaymentState::Success);
+}
@@ -8,11 +8,15 @@
 #import "AppDelegate.h"
 
 #import <React/RCTBundleURLProvider.h>
+#import "AppYarnPackageSetup.h"
 
 @implementation AppDelegate
 
 - (BOOL)application:(UIApplication *)application didFinishLaunchingWithOptions:(NSDictionary *)launchOptions
 {
+  // Initialise the SDK with the last config while the JS bundle loads.
+  [AppYarnPackageSetup preinitialize];
+
   self.moduleName = @"AppYarnPackageExample";
   // You can add your custom initial props in the dictionary below.
   // They will be passed down to the ViewController used by React Native.
@@ -9,7 +9,6 @@ import {
   Text,
   useColorScheme,
   View,
-  TouchableHighlight,
 } from 'react-native';
 
 import { AppYarnPackageView, SDKEnvironment } from '/Users/19046354/AppYarnPackage/src/index';
@@ -89,14 +88,15 @@ export default function App(): JSX.Element {
               />
           </Section>
           <Section title="Native button:">
-          <TouchableHighlight onPress={onPressSPayButton} underlayColor="white">
-            
-             <AppYarnPackageView style={{
+          <AppYarnPackageView
+            style={{
               height: 100,
               width: 112,
               paddingHorizontal: 16,
-            }} color={''}          />
-          </TouchableHighlight>
+            }}
+            paymentRequest={buttonPaymentRequest}
+            onPaymentResult={onSPayButtonResult}
+          />
          </Section>
     </ScrollView>
     </SafeAreaView>
@@ -195,8 +195,17 @@ payWithPartPay(
   )
 }
 
-function onPressSPayButton() {
-  Alert.alert('Button pressed')
+const buttonPaymentRequest = {
+  'merchantLogin': 'mineev_sdk',
+  'bankInvoiceId': 'b38892a1784d45db81a1a89134946cf1',
+  'orderNumber': '412',
+  'language': 'rus',
+  'redirectUri': 'sdkdpxxaqglg://spay',
+  'apiKey': 'AJpyllTD+0LKpCMDVZEB2ecAAAAAAAAADDLBcwrQjr5bOjn3yzYlFpCBk1nyQ9J46Ar3DrFBNyA92UJ7g/8zwuNose2pNnduv8JnjxD4h3HXdK8jTQB3pu7/HWqntPpBUCaA/8wqXK/gbgbJdWCU/7hzbtdYkxSD0u3qau9/4wM1p9WgkzNEPtPJE/gRKMk='
+}
+
+function onSPayButtonResult(event: { nativeEvent: { state: string, info: string } }) {
+  Alert.alert(`Button pay with status: ${event.nativeEvent.state}`)
 }
 
 const styles = StyleSheet.create({
@@ -1,13 +1,14 @@
+#import <React/RCTEventEmitter.h>
+#import <SPaySdk/SPaySdk.h>
 
 #ifdef RCT_NEW_ARCH_ENABLED
 #import "RNAppYarnPackageSpec.h"
 
-@interface AppYarnPackage : NSObject <NativeAppYarnPackageSpec>
+@interface AppYarnPackage : RCTEventEmitter <NativeAppYarnPackageSpec>
 #else
 #import <React/RCTBridgeModule.h>
-#import <SPaySdk/SPaySdk.h>
 
-@interface AppYarnPackage : NSObject <RCTBridgeModule>
+@interface AppYarnPackage : RCTEventEmitter <RCTBridgeModule>
 #endif
 
 @end
@@ -0,0 +1,524 @@
+//
+//  AppYarnPackage.mm
+//  demo-project
+//
+//  Created by Гладкий Сергей Игоревич on 13.09.2024.
+//
+
+#import "AppYarnPackage.h"
+#import "AppYarnPackageJSI.h"
+#import "AppYarnPackagePresenter.h"
+#import "AppYarnPackageSetup.h"
+#import "AppYarnPackageTrace.h"
+
+#ifdef RCT_NEW_ARCH_ENABLED
+#if __has_include(<ReactCommon/RCTTurboModuleWithJSIBindings.h>)
+#import <ReactCommon/RCTTurboModuleWithJSIBindings.h>
+#define APP_YARN_PACKAGE_JSI_BINDINGS 1
+#endif
+#endif
+
+#include "LatencyHistogram.h"
+#include "PaymentScheduler.h"
+
+using spaybridge::DropReason;
+using spaybridge::ErrorCategory;
+using spaybridge::LatencyRecorder;
+using spaybridge::Operation;
+using spaybridge::PaymentScheduler;
+using spaybridge::PaymentState;
+
+static NSString *const kReadinessChangedEvent = @"AppYarnPackageReadinessChanged";
+static NSString *const kPaymentStateChangedEvent = @"AppYarnPackagePaymentStateChanged";
+// How long an abandoned payment's sheet may keep the scheduler slot before
+// the next payment is let through anyway.
+static const int64_t kAbandonedSlotGraceSeconds = 60;
+
+// Values match spaybridge::PayMethod.
+typedef NS_ENUM(NSInteger, AppYarnPayMethod) {
+  AppYarnPayMethodBankInvoiceId,
+  AppYarnPayMethodWithoutRefresh,
+  AppYarnPayMethodPartPay,
+};
+
+// Per-call options carried by the payment request next to the SDK fields.
+struct AppYarnPaymentOptions {
+  NSString *sessionId;
+  BOOL headless;
+  spaybridge::SchedulingPolicy policy;
+  int priority;
+};
+
+#ifdef APP_YARN_PACKAGE_JSI_BINDINGS
+// Installs __SPayBridge as the TurboModule is created, which also works in
+// bridgeless mode where installJSI has no bridge to read the runtime from.
+@interface AppYarnPackage () <RCTTurboModuleWithJSIBindings>
+@end
+#endif
+
+typedef void (^SPayCompletion)(enum SPayState state, NSString * _Nonnull info, NSString * _Nullable localSessionId);
+typedef void (^AppYarnPaymentReply)(enum SPayState state, ErrorCategory category, NSString * _Nullable info, NSString * _Nullable localSessionId);
+
+@implementation AppYarnPackage
+{
+  BOOL _hasListeners;
+  NSNumber *_lastReadiness;
+  // Callbacks of payments that haven't answered JS yet, by session id.
+  NSMutableDictionary<NSString *, RCTResponseSenderBlock> *_pendingReplies;
+  AppYarnPackageJSI *_jsi;
+#ifdef RCT_NEW_ARCH_ENABLED
+  // Set by getTurboModule:, which the TurboModule manager calls before
+  // installJSIBindingsWithRuntime:.
+  std::shared_ptr<facebook::react::CallInvoker> _jsInvoker;
+#endif
+}
+RCT_EXPORT_MODULE()
+
++ (BOOL)requiresMainQueueSetup
+{
+  return NO;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+	_jsi = [AppYarnPackageJSI new];
+  }
+  return self;
+}
+
+- (void)invalidate
+{
+  [_jsi invalidate];
+  [super invalidate];
+}
+
+- (NSArray<NSString *> *)supportedEvents
+{
+  return @[kReadinessChangedEvent, kPaymentStateChangedEvent];
+}
+
+- (void)startObserving
+{
+  _hasListeners = YES;
+  [[NSNotificationCenter defaultCenter] addObserver:self
+										   selector:@selector(applicationWillEnterForeground:)
+											   name:UIApplicationWillEnterForegroundNotification
+											 object:nil];
+}
+
+- (void)stopObserving
+{
+  _hasListeners = NO;
+  [[NSNotificationCenter defaultCenter] removeObserver:self
+												  name:UIApplicationWillEnterForegroundNotification
+												object:nil];
+}
+
+- (void)applicationWillEnterForeground:(NSNotification *)notification
+{
+  [self refreshReadiness];
+}
+
+// Readiness can only change after setup or when the user comes back from the
+// bank app, so it is re-read at those points and pushed to JS if it differs.
+- (BOOL)refreshReadiness
+{
+  BOOL isReady = [SPay isReadyForSPay];
+  @synchronized (self) {
+	if (_lastReadiness != nil && _lastReadiness.boolValue == isReady) {
+	  return isReady;
+	}
+	_lastReadiness = @(isReady);
+  }
+  [_jsi reportReadiness:isReady];
+  if (_hasListeners) {
+	[self sendEventWithName:kReadinessChangedEvent body:@{@"isReady": @(isReady)}];
+  }
+  return isReady;
+}
+
+#ifdef RCT_NEW_ARCH_ENABLED
+- (void)setupSDK:(JS::NativeAppYarnPackage::SPaySetupParams &)params
+	 environment:(double)environment
+		callback:(RCTResponseSenderBlock)callback
+{
+  [self setupWithConfig:@{
+	@"bnplPlan": @(params.bnplPlan()),
+	@"resultViewNeeded": @(params.resultViewNeeded()),
+	@"helpers": @(params.helpers()),
+	@"needLogs": @(params.needLogs()),
+	@"sbp": @(params.sbp()),
+	@"creditCard": @(params.creditCard()),
+	@"debitCard": @(params.debitCard()),
+  }
+			environment:(NSInteger)environment
+			   callback:callback];
+}
+
+- (void)payWithBankInvoiceId:(JS::NativeAppYarnPackage::SPayPaymentRequest &)params
+					callback:(RCTResponseSenderBlock)callback
+{
+  [self pay:AppYarnPayMethodBankInvoiceId request:[self paymentRequestFromSpec:params] options:[self paymentOptionsFromSpec:params] callback:callback];
+}
+
+- (void)payWithoutRefresh:(JS::NativeAppYarnPackage::SPayPaymentRequest &)params
+				 callback:(RCTResponseSenderBlock)callback
+{
+  [self pay:AppYarnPayMethodWithoutRefresh request:[self paymentRequestFromSpec:params] options:[self paymentOptionsFromSpec:params] callback:callback];
+}
+
+- (void)payWithPartPay:(JS::NativeAppYarnPackage::SPayPaymentRequest &)params
+			  callback:(RCTResponseSenderBlock)callback
+{
+  [self pay:AppYarnPayMethodPartPay request:[self paymentRequestFromSpec:params] options:[self paymentOptionsFromSpec:params] callback:callback];
+}
+
+- (SBankInvoiceIdPaymentRequest *)paymentRequestFromSpec:(JS::NativeAppYarnPackage::SPayPaymentRequest &)params
+{
+  return [[SBankInvoiceIdPaymentRequest alloc] initWithMerchantLogin:params.merchantLogin()
+													   bankInvoiceId:params.bankInvoiceId()
+														 orderNumber:params.orderNumber()
+															language:params.language()
+														 redirectUri:params.redirectUri()
+															  apiKey:params.apiKey()];
+}
+
+- (AppYarnPaymentOptions)paymentOptionsFromSpec:(JS::NativeAppYarnPackage::SPayPaymentRequest &)params
+{
+  NSString *policy = params.policy();
+  return {
+	params.sessionId() ?: [NSUUID UUID].UUIDString,
+	params.headless().value_or(false),
+	spaybridge::schedulingPolicyFromString(policy.length > 0 ? policy.UTF8String : ""),
+	static_cast<int>(params.priority().value_or(0)),
+  };
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:
+	(const facebook::react::ObjCTurboModule::InitParams &)params
+{
+  _jsInvoker = params.jsInvoker;
+  return std::make_shared<facebook::react::NativeAppYarnPackageSpecJSI>(params);
+}
+
+#ifdef APP_YARN_PACKAGE_JSI_BINDINGS
+- (void)installJSIBindingsWithRuntime:(facebook::jsi::Runtime &)runtime
+{
+  [_jsi installWithRuntime:runtime callInvoker:_jsInvoker];
+}
+#endif
+#else
+RCT_EXPORT_METHOD(setupSDK: (NSDictionary *)params
+				  environment: (NSInteger)environment
+				  callback: (RCTResponseSenderBlock)callback)
+{
+  NSMutableDictionary *config = [NSMutableDictionary dictionary];
+  for (NSString *flag in @[@"bnplPlan", @"resultViewNeeded", @"helpers", @"needLogs", @"sbp", @"creditCard", @"debitCard"]) {
+	config[flag] = @([params[flag] boolValue]);
+  }
+  [self setupWithConfig:config environment:environment callback:callback];
+}
+
+RCT_EXPORT_METHOD(payWithBankInvoiceId: (NSDictionary *)params callback: (RCTResponseSenderBlock)callback)
+{
+  [self pay:AppYarnPayMethodBankInvoiceId request:[self paymentRequestFromDictionary:params] options:[self paymentOptionsFromDictionary:params] callback:callback];
+}
+
+RCT_EXPORT_METHOD(payWithoutRefresh: (NSDictionary *)params callback: (RCTResponseSenderBlock)callback)
+{
+  [self pay:AppYarnPayMethodWithoutRefresh request:[self paymentRequestFromDictionary:params] options:[self paymentOptionsFromDictionary:params] callback:callback];
+}
+
+RCT_EXPORT_METHOD(payWithPartPay: (NSDictionary *)params callback: (RCTResponseSenderBlock)callback)
+{
+  [self pay:AppYarnPayMethodPartPay request:[self paymentRequestFromDictionary:params] options:[self paymentOptionsFromDictionary:params] callback:callback];
+}
+
+- (SBankInvoiceIdPaymentRequest *)paymentRequestFromDictionary:(NSDictionary *)params
+{
+  return [[SBankInvoiceIdPaymentRequest alloc] initWithMerchantLogin:params[@"merchantLogin"]
+													   bankInvoiceId:params[@"bankInvoiceId"]
+														 orderNumber:params[@"orderNumber"]
+															language:params[@"language"]
+														 redirectUri:params[@"redirectUri"]
+															  apiKey:params[@"apiKey"]];
+}
+
+- (AppYarnPaymentOptions)paymentOptionsFromDictionary:(NSDictionary *)params
+{
+  NSString *policy = params[@"policy"];
+  return {
+	params[@"sessionId"] ?: [NSUUID UUID].UUIDString,
+	[params[@"headless"] boolValue],
+	spaybridge::schedulingPolicyFromString(policy.length > 0 ? policy.UTF8String : ""),
+	[params[@"priority"] intValue],
+  };
+}
+#endif
+
+// Already installed by installJSIBindingsWithRuntime: where the TurboModule
+// manager supports it; otherwise needs the bridge, so it fails in bridgeless
+// mode and JS stays on the module's async methods.
+RCT_EXPORT_BLOCKING_SYNCHRONOUS_METHOD(installJSI)
+{
+  return @([_jsi installWithBridge:self.bridge]);
+}
+
+// Small app-private key/value store for state the JS side keeps across
+// launches, such as cached payment tokens.
+static NSUserDefaults *AppYarnPackageStore(void)
+{
+  static NSUserDefaults *store;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+	store = [[NSUserDefaults alloc] initWithSuiteName:@"com.demoproject.AppYarnPackage"];
+  });
+  return store;
+}
+
+RCT_EXPORT_METHOD(getStoredValue:(NSString *)key callback:(RCTResponseSenderBlock)callback)
+{
+  callback(@[[AppYarnPackageStore() stringForKey:key] ?: [NSNull null]]);
+}
+
+RCT_EXPORT_METHOD(setStoredValue:(NSString *)key value:(NSString * _Nullable)value)
+{
+  if (value != nil) {
+	[AppYarnPackageStore() setObject:value forKey:key];
+  } else {
+	[AppYarnPackageStore() removeObjectForKey:key];
+  }
+}
+
+RCT_EXPORT_METHOD(isReadyForSPay:(RCTResponseSenderBlock)callback)
+{
+  auto startedAt = LatencyRecorder::Clock::now();
+  BOOL isReady = [self refreshReadiness];
+  LatencyRecorder::shared().record(Operation::IsReady, PaymentState::Success, startedAt);
+  callback(@[@(isReady)]);
+}
+
+// Drops a payment that is still waiting for another sheet to close.
+RCT_EXPORT_METHOD(cancelPayment:(NSString *)sessionId callback:(RCTResponseSenderBlock)callback)
+{
+  callback(@[@(PaymentScheduler::shared()->cancel(sessionId.UTF8String))]);
+}
+
+// Answers the session's callback with `code` right away, so neither side
+// keeps the call's closures alive if the SDK never calls back. A payment still
+// waiting in the queue is dropped; the active one keeps the scheduler slot
+// until the SDK reports a state, since its sheet may still be on screen, or
+// for kAbandonedSlotGraceSeconds at most. The SDK's late states are still
+// emitted as events.
+RCT_EXPORT_METHOD(abandonPayment:(NSString *)sessionId code:(double)code)
+{
+  RCTResponseSenderBlock callback = [self takePendingReply:sessionId];
+  if (callback == nil) {
+	return;
+  }
+  callback(@[@(code), @(static_cast<int>(ErrorCategory::None)), [NSNull null], [NSNull null], @{}]);
+  std::string ticket = sessionId.UTF8String;
+  if (!PaymentScheduler::shared()->cancel(ticket)) {
+	dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kAbandonedSlotGraceSeconds * NSEC_PER_SEC),
+				   dispatch_get_main_queue(), ^{
+	  PaymentScheduler::shared()->release(ticket);
+	});
+  }
+}
+
+// Everything startup needs in one round trip instead of separate setup,
+// readiness and config queries.
+RCT_EXPORT_METHOD(getStatus:(RCTResponseSenderBlock)callback)
+{
+  NSMutableDictionary *status = [[AppYarnPackageSetup status] mutableCopy] ?: [@{@"initState": @"idle"} mutableCopy];
+  status[@"isReady"] = @([self refreshReadiness]);
+  status[@"sdkVersion"] = [[NSBundle bundleForClass:[SPay class]] objectForInfoDictionaryKey:@"CFBundleShortVersionString"] ?: @"";
+  callback(@[status]);
+}
+
+RCT_EXPORT_METHOD(drainLatencyHistograms:(RCTResponseSenderBlock)callback)
+{
+  std::string json = spaybridge::toJson(LatencyRecorder::shared().drain());
+  callback(@[[NSString stringWithUTF8String:json.c_str()]]);
+}
+
+// `config` holds the SPaySetupParams flags as NSNumbers. Joins an init started
+// by +[AppYarnPackageSetup preinitialize] when the config matches.
+- (void)setupWithConfig:(NSDictionary<NSString *, NSNumber *> *)config
+			environment:(NSInteger)environment
+			   callback:(RCTResponseSenderBlock)callback
+{
+  auto startedAt = LatencyRecorder::Clock::now();
+  [AppYarnPackageSetup setupWithConfig:config environment:environment completion:^(NSString * _Nullable error) {
+	LatencyRecorder::shared().record(Operation::Setup, error ? PaymentState::Error : PaymentState::Success, startedAt);
+	callback(@[error ?: [NSNull null]]);
+	if (error == nil) {
+	  [self refreshReadiness];
+	}
+  }];
+}
+
+// Only one SDK sheet can be on screen, so payments go through the process-wide
+// scheduler and start once the previous sheet has reported its first state.
+- (void)pay:(AppYarnPayMethod)method
+	request:(SBankInvoiceIdPaymentRequest *)request
+	options:(AppYarnPaymentOptions)options
+   callback:(RCTResponseSenderBlock)callback
+{
+  AppYarnPackageTrace *trace = [AppYarnPackageTrace new];
+  std::string ticket = options.sessionId.UTF8String;
+  std::shared_ptr<PaymentScheduler> scheduler = PaymentScheduler::shared();
+  AppYarnPaymentReply reply = [self replyForSession:options.sessionId
+											   method:method
+												trace:trace
+											 callback:callback];
+  __block BOOL sheetClosed = NO;
+  AppYarnPaymentReply report = ^(enum SPayState state, ErrorCategory category, NSString * _Nullable info, NSString * _Nullable localSessionId) {
+	reply(state, category, info, localSessionId);
+	if (!sheetClosed) {
+	  sheetClosed = YES;
+	  scheduler->finish(ticket);
+	}
+  };
+  SPayCompletion completion = ^(enum SPayState state, NSString * _Nonnull info, NSString * _Nullable localSessionId) {
+	// SPayState values match spaybridge::PaymentState.
+	report(state, spaybridge::categoryFor(static_cast<PaymentState>(state)), info, localSessionId);
+  };
+  BOOL headless = options.headless;
+
+  PaymentScheduler::Job job;
+  job.id = ticket;
+  job.priority = options.priority;
+  job.start = [=] {
+	[trace mark:@"started"];
+	dispatch_async(dispatch_get_main_queue(), ^{
+	  [trace mark:@"mainQueue"];
+	  if (headless) {
+		// The SDK presents itself, no view controller lookup at all.
+		[trace mark:@"sdkInvoked"];
+		switch (method) {
+		  case AppYarnPayMethodBankInvoiceId:
+			[SPay payWithBankInvoiceIdWithPaymentRequest:request completion:completion];
+			break;
+		  case AppYarnPayMethodWithoutRefresh:
+			[SPay payWithoutRefreshWithPaymentRequest:request completion:completion];
+			break;
+		  case AppYarnPayMethodPartPay:
+			[SPay payWithPartPayWithPaymentRequest:request completion:completion];
+			break;
+		}
+		return;
+	  }
+	  UIViewController *presenter = [[AppYarnPackagePresenter sharedPresenter] topViewController];
+	  [trace mark:@"presenterResolved"];
+	  if (presenter == nil) {
+		report(SPayStateError, ErrorCategory::Presentation, @"The view controller is not available", nil);
+		return;
+	  }
+	  [trace mark:@"sdkInvoked"];
+	  switch (method) {
+		case AppYarnPayMethodBankInvoiceId:
+		  [SPay payWithBankInvoiceIdWith:presenter paymentRequest:request completion:completion];
+		  break;
+		case AppYarnPayMethodWithoutRefresh:
+		  [SPay payWithoutRefreshWith:presenter paymentRequest:request completion:completion];
+		  break;
+		case AppYarnPayMethodPartPay:
+		  [SPay payWithPartPayWith:presenter paymentRequest:request completion:completion];
+		  break;
+	  }
+	});
+  };
+  job.drop = [reply](DropReason reason) {
+	NSString *info = [NSString stringWithUTF8String:spaybridge::describe(reason)];
+	if (reason == DropReason::Cancelled) {
+	  reply(SPayStateCancel, ErrorCategory::None, info, nil);
+	} else {
+	  reply(SPayStateError, ErrorCategory::Scheduling, info, nil);
+	}
+  };
+  scheduler->submit(options.policy, std::move(job));
+}
+
+// The SDK may report `waiting` and later the final state for the same session.
+// Every transition is streamed to JS, the callback only receives the first one
+// as (code, category, info, localSessionId) together with the trace marks up
+// to that point.
+- (AppYarnPaymentReply)replyForSession:(NSString *)sessionId
+								method:(AppYarnPayMethod)method
+								 trace:(AppYarnPackageTrace *)trace
+							  callback:(RCTResponseSenderBlock)callback
+{
+  // The SDK owns the completion for as long as it likes; keeping the callback
+  // out of it lets abandonPayment release the JS side independently.
+  @synchronized (self) {
+	if (_pendingReplies == nil) {
+	  _pendingReplies = [NSMutableDictionary new];
+	}
+	_pendingReplies[sessionId] = callback;
+  }
+  auto startedAt = LatencyRecorder::Clock::now();
+  Operation operation = spaybridge::operationFor(static_cast<spaybridge::PayMethod>(method));
+  return ^(enum SPayState state, ErrorCategory category, NSString * _Nullable info, NSString * _Nullable localSessionId) {
+	NSString *stateName = @"error";
+	switch(state) {
+	  case SPayStateSuccess:
+		stateName = @"success";
+		break;
+	  case SPayStateWaiting:
+		stateName = @"waiting";
+		break;
+	  case SPayStateCancel:
+		stateName = @"cancel";
+		break;
+	  case SPayStateError:
+		stateName = @"error";
+		break;
+	}
+	[self emitPaymentState:stateName session:sessionId info:info localSessionId:localSessionId];
+
+	RCTResponseSenderBlock reply = [self takePendingReply:sessionId];
+	if (reply == nil) {
+	  return;
+	}
+	[trace mark:@"completed"];
+	LatencyRecorder::shared().record(operation, static_cast<PaymentState>(state), startedAt);
+	reply(@[
+	  @(state),
+	  @(static_cast<int>(category)),
+	  info.length > 0 ? info : [NSNull null],
+	  localSessionId ?: [NSNull null],
+	  trace.marks,
+	]);
+  };
+}
+
+- (RCTResponseSenderBlock)takePendingReply:(NSString *)sessionId
+{
+  @synchronized (self) {
+	RCTResponseSenderBlock callback = _pendingReplies[sessionId];
+	[_pendingReplies removeObjectForKey:sessionId];
+	return callback;
+  }
+}
+
+- (void)emitPaymentState:(NSString *)state
+				 session:(NSString *)sessionId
+					info:(NSString * _Nullable)info
+		  localSessionId:(NSString * _Nullable)localSessionId
+{
+  if (!_hasListeners) {
+	return;
+  }
+  NSMutableDictionary *body = [@{@"sessionId": sessionId, @"state": state} mutableCopy];
+  if (info.length > 0) {
+	body[@"info"] = info;
+  }
+  if (localSessionId != nil) {
+	body[@"localSessionId"] = localSessionId;
+  }
+  [self sendEventWithName:kPaymentStateChangedEvent body:body];
+}
+
+@end
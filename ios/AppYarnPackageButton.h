@@ -0,0 +1,28 @@
+//
+//  AppYarnPackageButton.h
+//  demo-project
+//
+
+#import <React/RCTComponent.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Hosts the SDK's SBPButton (which can't be subclassed) together with an
+// optional pre-bound payment request. When a request is set, a tap submits the
+// SDK flow to the process-wide payment scheduler and reports every state
+// through onPaymentResult.
+@interface AppYarnPackageButton : UIView
+
+@property (nonatomic, strong, nullable) UIColor *color;
+@property (nonatomic, copy, nullable) NSDictionary *paymentRequest;
+@property (nonatomic, copy, nullable) NSString *payMethod;
+@property (nonatomic, copy, nullable) RCTDirectEventBlock onPaymentResult;
+
+// Detaches a payment still in flight from the button, so the next mount can
+// start its own and never receives the previous mount's results.
+- (void)prepareForRecycle;
+
+@end
+
+NS_ASSUME_NONNULL_END
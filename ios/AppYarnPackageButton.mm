@@ -0,0 +1,157 @@
+//
+//  AppYarnPackageButton.mm
+//  demo-project
+//
+
+#import "AppYarnPackageButton.h"
+#import "AppYarnPackagePresenter.h"
+
+#import <React/UIView+React.h>
+#import <SPaySdk/SPaySdk.h>
+
+#include "PaymentScheduler.h"
+
+using spaybridge::DropReason;
+using spaybridge::PaymentScheduler;
+
+@implementation AppYarnPackageButton
+{
+  SBPButton *_button;
+  // The SDK button's own background, restored when `color` is unset.
+  UIColor *_defaultBackgroundColor;
+  BOOL _paymentInFlight;
+  // Bumped on recycle, so a payment started by the previous mount neither
+  // reports to the next one nor clears its _paymentInFlight.
+  NSUInteger _mount;
+}
+
+- (instancetype)initWithFrame:(CGRect)frame
+{
+  if (self = [super initWithFrame:frame]) {
+	_button = [[SBPButton alloc] init];
+	_defaultBackgroundColor = _button.backgroundColor;
+	_button.frame = self.bounds;
+	_button.autoresizingMask = UIViewAutoresizingFlexibleWidth | UIViewAutoresizingFlexibleHeight;
+	__weak AppYarnPackageButton *weakSelf = self;
+	_button.tapAction = ^{
+	  [weakSelf startPayment];
+	};
+	[self addSubview:_button];
+  }
+  return self;
+}
+
+- (void)prepareForRecycle
+{
+  _mount += 1;
+  _paymentInFlight = NO;
+}
+
+- (void)setColor:(UIColor *)color
+{
+  _color = color;
+  _button.backgroundColor = color ?: _defaultBackgroundColor;
+}
+
+// Goes through the same process-wide scheduler as the module's pay calls, so a
+// tap never opens a second SDK sheet over one that is still on screen.
+- (void)startPayment
+{
+  NSDictionary *params = self.paymentRequest;
+  if (params == nil || _paymentInFlight) {
+	return;
+  }
+  SBankInvoiceIdPaymentRequest *request = [[SBankInvoiceIdPaymentRequest alloc]
+										   initWithMerchantLogin:params[@"merchantLogin"]
+										   bankInvoiceId:params[@"bankInvoiceId"]
+										   orderNumber:params[@"orderNumber"]
+										   language:params[@"language"]
+										   redirectUri:params[@"redirectUri"]
+										   apiKey:params[@"apiKey"]];
+  NSString *payMethod = self.payMethod;
+  NSUInteger mount = _mount;
+  _paymentInFlight = YES;
+
+  std::string ticket = [NSString stringWithFormat:@"button-%@", [NSUUID UUID].UUIDString].UTF8String;
+  std::shared_ptr<PaymentScheduler> scheduler = PaymentScheduler::shared();
+  __weak AppYarnPackageButton *weakSelf = self;
+  __block BOOL sheetClosed = NO;
+  void (^report)(enum SPayState, NSString * _Nullable, NSString * _Nullable) =
+	^(enum SPayState state, NSString * _Nullable info, NSString * _Nullable localSessionId) {
+	  if (!sheetClosed) {
+		sheetClosed = YES;
+		scheduler->finish(ticket);
+	  }
+	  AppYarnPackageButton *strongSelf = weakSelf;
+	  if (strongSelf == nil || strongSelf->_mount != mount) {
+		return;
+	  }
+	  // The sheet is closed once the SDK reports anything, including waiting.
+	  strongSelf->_paymentInFlight = NO;
+	  NSString *stateName = @"error";
+	  switch (state) {
+		case SPayStateSuccess:
+		  stateName = @"success";
+		  break;
+		case SPayStateWaiting:
+		  stateName = @"waiting";
+		  break;
+		case SPayStateCancel:
+		  stateName = @"cancel";
+		  break;
+		case SPayStateError:
+		  stateName = @"error";
+		  break;
+	  }
+	  [strongSelf reportState:stateName info:info localSessionId:localSessionId];
+	};
+  void (^completion)(enum SPayState, NSString *, NSString *) =
+	^(enum SPayState state, NSString * _Nonnull info, NSString * _Nullable localSessionId) {
+	  report(state, info, localSessionId);
+	};
+
+  PaymentScheduler::Job job;
+  job.id = ticket;
+  job.start = [=] {
+	dispatch_async(dispatch_get_main_queue(), ^{
+	  UIViewController *presenter = weakSelf.reactViewController ?: [[AppYarnPackagePresenter sharedPresenter] topViewController];
+	  while (presenter.presentedViewController != nil && !presenter.presentedViewController.isBeingDismissed) {
+		presenter = presenter.presentedViewController;
+	  }
+	  if (presenter == nil) {
+		report(SPayStateError, @"The view controller is not available", nil);
+		return;
+	  }
+	  if ([payMethod isEqualToString:@"withoutRefresh"]) {
+		[SPay payWithoutRefreshWith:presenter paymentRequest:request completion:completion];
+	  } else if ([payMethod isEqualToString:@"partPay"]) {
+		[SPay payWithPartPayWith:presenter paymentRequest:request completion:completion];
+	  } else {
+		[SPay payWithBankInvoiceIdWith:presenter paymentRequest:request completion:completion];
+	  }
+	});
+  };
+  job.drop = [=](DropReason reason) {
+	NSString *info = [NSString stringWithUTF8String:spaybridge::describe(reason)];
+	enum SPayState state = reason == DropReason::Cancelled ? SPayStateCancel : SPayStateError;
+	// The scheduler ignores finish() for a payment that never started.
+	dispatch_async(dispatch_get_main_queue(), ^{
+	  report(state, info, nil);
+	});
+  };
+  scheduler->submit(spaybridge::SchedulingPolicy::Enqueue, std::move(job));
+}
+
+- (void)reportState:(NSString *)state info:(NSString * _Nullable)info localSessionId:(NSString * _Nullable)localSessionId
+{
+  if (self.onPaymentResult == nil) {
+	return;
+  }
+  self.onPaymentResult(@{
+	@"state": state,
+	@"info": info ?: @"",
+	@"localSessionId": localSessionId ?: @"",
+  });
+}
+
+@end
@@ -0,0 +1,34 @@
+//
+//  AppYarnPackageJSI.h
+//  demo-project
+//
+
+#import <React/RCTBridge.h>
+
+#ifdef __cplusplus
+#include <memory>
+
+#include <ReactCommon/CallInvoker.h>
+#include <jsi/jsi.h>
+#endif
+
+// Installs `global.__SPayBridge`, the JSI host object backed by the C++ core
+// in cpp/. One instance per module instance; the core it installs lives as
+// long as the JS runtime it was installed into.
+@interface AppYarnPackageJSI : NSObject
+
+// Legacy architecture: reads the runtime off the RCTCxxBridge, so it fails in
+// bridgeless mode where there is no bridge.
+- (BOOL)installWithBridge:(RCTBridge *)bridge;
+#ifdef __cplusplus
+// Any architecture, given the runtime and its JS call invoker, e.g. from
+// RCTTurboModuleWithJSIBindings.
+- (BOOL)installWithRuntime:(facebook::jsi::Runtime &)runtime
+			   callInvoker:(std::shared_ptr<facebook::react::CallInvoker>)callInvoker;
+#endif
+- (BOOL)isInstalled;
+- (void)reportReadiness:(BOOL)isReady;
+// Called when the module is invalidated, e.g. on a JS reload.
+- (void)invalidate;
+
+@end
@@ -0,0 +1,165 @@
+//
+//  AppYarnPackageJSI.mm
+//  demo-project
+//
+
+#import "AppYarnPackageJSI.h"
+#import "AppYarnPackageSetup.h"
+
+#import <React/RCTBridge+Private.h>
+#import <SPaySdk/SPaySdk.h>
+
+#include <mutex>
+
+#include "PaymentScheduler.h"
+#include "SPayBridge.h"
+#include "SPayHostObject.h"
+
+using namespace spaybridge;
+
+namespace {
+
+NSString *toNSString(const std::string &value)
+{
+  return [NSString stringWithUTF8String:value.c_str()];
+}
+
+PaymentState toPaymentState(enum SPayState state)
+{
+  switch (state) {
+	case SPayStateSuccess:
+	  return PaymentState::Success;
+	case SPayStateWaiting:
+	  return PaymentState::Waiting;
+	case SPayStateCancel:
+	  return PaymentState::Cancel;
+	case SPayStateError:
+	  return PaymentState::Error;
+  }
+  return PaymentState::Error;
+}
+
+// Uses the headless SDK entry points, so no view controller lookup is needed.
+class IOSPlatformBackend : public PlatformBackend {
+public:
+  void setup(const SetupConfig &config, SetupCallback callback) override
+  {
+	NSDictionary *flags = @{
+	  @"bnplPlan": @(config.bnplPlan),
+	  @"resultViewNeeded": @(config.resultViewNeeded),
+	  @"helpers": @(config.helpers),
+	  @"needLogs": @(config.needLogs),
+	  @"sbp": @(config.sbp),
+	  @"creditCard": @(config.creditCard),
+	  @"debitCard": @(config.debitCard),
+	};
+	[AppYarnPackageSetup setupWithConfig:flags
+							 environment:static_cast<NSInteger>(config.environment)
+							  completion:^(NSString * _Nullable error) {
+	  if (error != nil) {
+		callback(std::string(error.UTF8String ?: ""));
+	  } else {
+		callback(std::nullopt);
+	  }
+	}];
+  }
+
+  bool isReady() override
+  {
+	return [SPay isReadyForSPay];
+  }
+
+  void pay(PayMethod method, const PaymentRequest &request, PaymentCallback callback) override
+  {
+	SBankInvoiceIdPaymentRequest *paymentRequest = [[SBankInvoiceIdPaymentRequest alloc]
+													initWithMerchantLogin:toNSString(request.merchantLogin)
+													bankInvoiceId:toNSString(request.bankInvoiceId)
+													orderNumber:toNSString(request.orderNumber)
+													language:toNSString(request.language)
+													redirectUri:toNSString(request.redirectUri)
+													apiKey:toNSString(request.apiKey)];
+	void (^completion)(enum SPayState, NSString *, NSString *) =
+	  ^(enum SPayState state, NSString * _Nonnull info, NSString * _Nullable localSessionId) {
+		PaymentState paymentState = toPaymentState(state);
+		callback({paymentState, info.UTF8String ?: "", localSessionId.UTF8String ?: "", categoryFor(paymentState)});
+	  };
+	dispatch_async(dispatch_get_main_queue(), ^{
+	  switch (method) {
+		case PayMethod::BankInvoiceId:
+		  [SPay payWithBankInvoiceIdWithPaymentRequest:paymentRequest completion:completion];
+		  break;
+		case PayMethod::WithoutRefresh:
+		  [SPay payWithoutRefreshWithPaymentRequest:paymentRequest completion:completion];
+		  break;
+		case PayMethod::PartPay:
+		  [SPay payWithPartPayWithPaymentRequest:paymentRequest completion:completion];
+		  break;
+	  }
+	});
+  }
+};
+
+} // namespace
+
+@implementation AppYarnPackageJSI
+{
+  // Owned by the host object in the runtime, so it goes away with the runtime
+  // and never holds JS callbacks past it.
+  std::weak_ptr<SPayBridge> _bridge;
+  std::mutex _mutex;
+}
+
+- (std::shared_ptr<SPayBridge>)currentBridge
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _bridge.lock();
+}
+
+- (void)reportReadiness:(BOOL)isReady
+{
+  if (auto bridge = [self currentBridge]) {
+	bridge->updateReadiness(isReady);
+  }
+}
+
+- (BOOL)isInstalled
+{
+  return [self currentBridge] != nullptr;
+}
+
+- (BOOL)installWithBridge:(RCTBridge *)bridge
+{
+  if ([self isInstalled]) {
+	return YES;
+  }
+  RCTCxxBridge *cxxBridge = (RCTCxxBridge *)bridge;
+  if (cxxBridge == nil || cxxBridge.runtime == nullptr) {
+	return NO;
+  }
+  return [self installWithRuntime:*static_cast<facebook::jsi::Runtime *>(cxxBridge.runtime)
+					  callInvoker:cxxBridge.jsCallInvoker];
+}
+
+- (BOOL)installWithRuntime:(facebook::jsi::Runtime &)runtime
+			   callInvoker:(std::shared_ptr<facebook::react::CallInvoker>)callInvoker
+{
+  if ([self isInstalled]) {
+	return YES;
+  }
+  if (callInvoker == nullptr) {
+	return NO;
+  }
+  auto core = std::make_shared<SPayBridge>(std::make_shared<IOSPlatformBackend>(), PaymentScheduler::shared());
+  SPayHostObject::install(runtime, core, std::move(callInvoker));
+  std::lock_guard<std::mutex> lock(_mutex);
+  _bridge = core;
+  return YES;
+}
+
+- (void)invalidate
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _bridge.reset();
+}
+
+@end
@@ -0,0 +1,22 @@
+//
+//  AppYarnPackagePresenter.h
+//  demo-project
+//
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Tracks the key window of the foreground scene from UIKit notifications, so
+// finding the controller to present the SDK sheet from is a walk up the modal
+// presentation chain only, instead of a recursive hierarchy traversal.
+@interface AppYarnPackagePresenter : NSObject
+
++ (instancetype)sharedPresenter;
+
+// Must be called on the main thread.
+- (nullable UIViewController *)topViewController;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,85 @@
+//
+//  AppYarnPackagePresenter.m
+//  demo-project
+//
+
+#import "AppYarnPackagePresenter.h"
+
+@implementation AppYarnPackagePresenter
+{
+  __weak UIWindow *_keyWindow;
+}
+
++ (instancetype)sharedPresenter
+{
+  static AppYarnPackagePresenter *presenter;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+	presenter = [AppYarnPackagePresenter new];
+  });
+  return presenter;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+	NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+	[center addObserver:self
+			   selector:@selector(windowDidBecomeKey:)
+				   name:UIWindowDidBecomeKeyNotification
+				 object:nil];
+	[center addObserver:self
+			   selector:@selector(invalidateKeyWindow:)
+				   name:UIWindowDidResignKeyNotification
+				 object:nil];
+	[center addObserver:self
+			   selector:@selector(invalidateKeyWindow:)
+				   name:UISceneDidActivateNotification
+				 object:nil];
+  }
+  return self;
+}
+
+- (void)windowDidBecomeKey:(NSNotification *)notification
+{
+  _keyWindow = notification.object;
+}
+
+- (void)invalidateKeyWindow:(NSNotification *)notification
+{
+  _keyWindow = nil;
+}
+
+- (nullable UIWindow *)keyWindow
+{
+  UIWindow *window = _keyWindow;
+  if (window != nil && window.isKeyWindow) {
+	return window;
+  }
+  UIWindow *fallback = nil;
+  for (UIScene *scene in [UIApplication sharedApplication].connectedScenes) {
+	if (scene.activationState != UISceneActivationStateForegroundActive ||
+		![scene isKindOfClass:[UIWindowScene class]]) {
+	  continue;
+	}
+	for (UIWindow *candidate in ((UIWindowScene *)scene).windows) {
+	  if (candidate.isKeyWindow) {
+		_keyWindow = candidate;
+		return candidate;
+	  }
+	  fallback = fallback ?: candidate;
+	}
+  }
+  return fallback;
+}
+
+- (nullable UIViewController *)topViewController
+{
+  UIViewController *controller = [self keyWindow].rootViewController;
+  while (controller.presentedViewController != nil && !controller.presentedViewController.isBeingDismissed) {
+	controller = controller.presentedViewController;
+  }
+  return controller;
+}
+
+@end
@@ -0,0 +1,37 @@
+//
+//  AppYarnPackageSetup.h
+//  demo-project
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^AppYarnPackageSetupCompletion)(NSString * _Nullable error);
+
+// Single owner of SDK initialisation for the module, the JSI bridge and
+// +preinitialize. A config that is being or has been initialised successfully
+// is joined instead of initialising the SDK again, so a JS setupSDK call
+// attaches to an init started before the bundle loaded.
+@interface AppYarnPackageSetup : NSObject
+
+// Starts initialising the SDK with the config of the last successful setup.
+// Call it from application:didFinishLaunchingWithOptions:; it returns without
+// waiting, and NO when no setup has succeeded yet.
++ (BOOL)preinitialize;
+
+// Same with a config declared by the app. `config` holds the SPaySetupParams
+// flags as NSNumbers, `environment` is an SEnvironment value.
++ (void)preinitializeWithConfig:(NSDictionary<NSString *, NSNumber *> *)config
+					environment:(NSInteger)environment;
+
++ (void)setupWithConfig:(NSDictionary<NSString *, NSNumber *> *)config
+			environment:(NSInteger)environment
+			 completion:(nullable AppYarnPackageSetupCompletion)completion;
+
+// initState, initError, environment and config of the latest setup, or nil.
++ (nullable NSDictionary *)status;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,133 @@
+//
+//  AppYarnPackageSetup.m
+//  demo-project
+//
+
+#import "AppYarnPackageSetup.h"
+#import <SPaySdk/SPaySdk.h>
+
+static NSString *const kPersistedConfigKey = @"com.demoproject.AppYarnPackage.setupConfig";
+
+// SDKEnvironment.EnvironmentStandIn, which only the Android module implements.
+static const NSInteger kStandInEnvironment = 3;
+
+@interface AppYarnPackageSetupInit : NSObject
+@property (nonatomic, copy) NSDictionary<NSString *, NSNumber *> *config;
+@property (nonatomic) NSInteger environment;
+@property (nonatomic, copy) NSString *state;
+@property (nonatomic, copy, nullable) NSString *error;
+@property (nonatomic, strong) NSMutableArray<AppYarnPackageSetupCompletion> *waiters;
+@end
+
+@implementation AppYarnPackageSetupInit
+@end
+
+@implementation AppYarnPackageSetup
+
+// The latest init; guarded by @synchronized on the class.
+static AppYarnPackageSetupInit *current;
+
++ (BOOL)preinitialize
+{
+  NSDictionary *persisted = [[NSUserDefaults standardUserDefaults] dictionaryForKey:kPersistedConfigKey];
+  NSDictionary *config = persisted[@"config"];
+  if (![config isKindOfClass:[NSDictionary class]]) {
+	return NO;
+  }
+  [self setupWithConfig:config environment:[persisted[@"environment"] integerValue] completion:nil];
+  return YES;
+}
+
++ (void)preinitializeWithConfig:(NSDictionary<NSString *, NSNumber *> *)config
+					environment:(NSInteger)environment
+{
+  [self setupWithConfig:config environment:environment completion:nil];
+}
+
++ (void)setupWithConfig:(NSDictionary<NSString *, NSNumber *> *)config
+			environment:(NSInteger)environment
+			 completion:(AppYarnPackageSetupCompletion)completion
+{
+  if (environment == kStandInEnvironment) {
+	if (completion != nil) {
+	  completion(@"The stand-in environment is only available on Android");
+	}
+	return;
+  }
+  AppYarnPackageSetupInit *init = nil;
+  BOOL replay = NO;
+  @synchronized (self) {
+	if (current != nil && current.environment == environment && [current.config isEqualToDictionary:config] &&
+		![current.state isEqualToString:@"failed"]) {
+	  if ([current.state isEqualToString:@"pending"]) {
+		if (completion != nil) {
+		  [current.waiters addObject:completion];
+		}
+	  } else {
+		replay = YES;
+	  }
+	} else {
+	  init = [AppYarnPackageSetupInit new];
+	  init.config = config;
+	  init.environment = environment;
+	  init.state = @"pending";
+	  init.waiters = [NSMutableArray array];
+	  if (completion != nil) {
+		[init.waiters addObject:completion];
+	  }
+	  current = init;
+	}
+  }
+  if (replay && completion != nil) {
+	completion(nil);
+  }
+  if (init == nil) {
+	return;
+  }
+
+  SConfig *helperConfig = [[SConfig alloc] initWithSbp:config[@"sbp"].boolValue
+											creditCard:config[@"creditCard"].boolValue
+											 debitCard:config[@"debitCard"].boolValue];
+  [SPay setupWithBnplPlan:config[@"bnplPlan"].boolValue
+		 resultViewNeeded:config[@"resultViewNeeded"].boolValue
+				  helpers:config[@"helpers"].boolValue
+				 needLogs:config[@"needLogs"].boolValue
+			 helperConfig:helperConfig
+			  environment:(SEnvironment)environment
+			   completion:^(SPError * _Nullable error) {
+	if (error == nil) {
+	  [[NSUserDefaults standardUserDefaults] setObject:@{@"config": config, @"environment": @(environment)}
+												forKey:kPersistedConfigKey];
+	}
+	NSArray<AppYarnPackageSetupCompletion> *waiters;
+	@synchronized (self) {
+	  init.state = error == nil ? @"ready" : @"failed";
+	  init.error = error.description;
+	  waiters = [init.waiters copy];
+	  [init.waiters removeAllObjects];
+	}
+	for (AppYarnPackageSetupCompletion waiter in waiters) {
+	  waiter(error.description);
+	}
+  }];
+}
+
++ (NSDictionary *)status
+{
+  @synchronized (self) {
+	if (current == nil) {
+	  return nil;
+	}
+	NSMutableDictionary *status = [@{
+	  @"initState": current.state,
+	  @"environment": @(current.environment),
+	  @"config": current.config,
+	} mutableCopy];
+	if (current.error != nil) {
+	  status[@"initError"] = current.error;
+	}
+	return status;
+  }
+}
+
+@end
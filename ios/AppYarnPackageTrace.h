@@ -0,0 +1,20 @@
+//
+//  AppYarnPackageTrace.h
+//  demo-project
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Monotonic timestamps of the native stages of one payment call, in
+// milliseconds since the call reached the module. Safe to mark from any thread.
+@interface AppYarnPackageTrace : NSObject
+
+- (void)mark:(NSString *)stage;
+
+- (NSDictionary<NSString *, NSNumber *> *)marks;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,39 @@
+//
+//  AppYarnPackageTrace.m
+//  demo-project
+//
+
+#import "AppYarnPackageTrace.h"
+#import <QuartzCore/QuartzCore.h>
+
+@implementation AppYarnPackageTrace
+{
+  CFTimeInterval _start;
+  NSMutableDictionary<NSString *, NSNumber *> *_marks;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+	_start = CACurrentMediaTime();
+	_marks = [NSMutableDictionary dictionaryWithObject:@0 forKey:@"received"];
+  }
+  return self;
+}
+
+- (void)mark:(NSString *)stage
+{
+  NSNumber *offset = @((CACurrentMediaTime() - _start) * 1000.0);
+  @synchronized (self) {
+	_marks[stage] = offset;
+  }
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)marks
+{
+  @synchronized (self) {
+	return [_marks copy];
+  }
+}
+
+@end
@@ -0,0 +1,19 @@
+//
+//  AppYarnPackageView.h
+//  demo-project
+//
+
+#ifdef RCT_NEW_ARCH_ENABLED
+#import <React/RCTViewComponentView.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Fabric component view hosting a single AppYarnPackageButton. Fabric keeps unmounted
+// component views in its recycle pool, so the SDK button is created once per
+// pooled view instead of once per mounted cell.
+@interface AppYarnPackageView : RCTViewComponentView
+@end
+
+NS_ASSUME_NONNULL_END
+#endif
@@ -0,0 +1,124 @@
+//
+//  AppYarnPackageView.mm
+//  demo-project
+//
+
+#ifdef RCT_NEW_ARCH_ENABLED
+#import "AppYarnPackageView.h"
+
+#import <React/RCTConversions.h>
+
+#import "AppYarnPackageButton.h"
+
+#import <react/renderer/components/RNAppYarnPackageSpec/ComponentDescriptors.h>
+#import <react/renderer/components/RNAppYarnPackageSpec/EventEmitters.h>
+#import <react/renderer/components/RNAppYarnPackageSpec/Props.h>
+#import <react/renderer/components/RNAppYarnPackageSpec/RCTComponentViewHelpers.h>
+
+#import "RCTFabricComponentsPlugins.h"
+
+using namespace facebook::react;
+
+static Props::Shared AppYarnPackageViewDefaultProps()
+{
+  static const auto defaultProps = std::make_shared<const AppYarnPackageViewProps>();
+  return defaultProps;
+}
+
+static BOOL AppYarnPackageViewRequestsEqual(const AppYarnPackageViewPaymentRequestStruct &lhs,
+											 const AppYarnPackageViewPaymentRequestStruct &rhs)
+{
+  return lhs.merchantLogin == rhs.merchantLogin && lhs.bankInvoiceId == rhs.bankInvoiceId &&
+		 lhs.orderNumber == rhs.orderNumber && lhs.language == rhs.language &&
+		 lhs.redirectUri == rhs.redirectUri && lhs.apiKey == rhs.apiKey;
+}
+
+static NSString *AppYarnPackageViewString(const std::string &value)
+{
+  return [NSString stringWithUTF8String:value.c_str()];
+}
+
+@interface AppYarnPackageView () <RCTAppYarnPackageViewViewProtocol>
+@end
+
+@implementation AppYarnPackageView {
+  AppYarnPackageButton *_button;
+}
+
++ (ComponentDescriptorProvider)componentDescriptorProvider
+{
+  return concreteComponentDescriptorProvider<AppYarnPackageViewComponentDescriptor>();
+}
+
+- (instancetype)initWithFrame:(CGRect)frame
+{
+  if (self = [super initWithFrame:frame]) {
+	_props = AppYarnPackageViewDefaultProps();
+	_button = [[AppYarnPackageButton alloc] init];
+	__weak AppYarnPackageView *weakSelf = self;
+	_button.onPaymentResult = ^(NSDictionary *body) {
+	  [weakSelf emitPaymentResult:body];
+	};
+	self.contentView = _button;
+  }
+  return self;
+}
+
+- (void)updateProps:(Props::Shared const &)props oldProps:(Props::Shared const &)oldProps
+{
+  const auto &oldViewProps = *std::static_pointer_cast<AppYarnPackageViewProps const>(_props);
+  const auto &newViewProps = *std::static_pointer_cast<AppYarnPackageViewProps const>(props);
+
+  if (oldViewProps.color != newViewProps.color) {
+	_button.color = RCTUIColorFromSharedColor(newViewProps.color);
+  }
+  if (!AppYarnPackageViewRequestsEqual(oldViewProps.paymentRequest, newViewProps.paymentRequest)) {
+	const auto &request = newViewProps.paymentRequest;
+	_button.paymentRequest = request.bankInvoiceId.empty() ? nil : @{
+	  @"merchantLogin": AppYarnPackageViewString(request.merchantLogin),
+	  @"bankInvoiceId": AppYarnPackageViewString(request.bankInvoiceId),
+	  @"orderNumber": AppYarnPackageViewString(request.orderNumber),
+	  @"language": AppYarnPackageViewString(request.language),
+	  @"redirectUri": AppYarnPackageViewString(request.redirectUri),
+	  @"apiKey": AppYarnPackageViewString(request.apiKey),
+	};
+  }
+  if (oldViewProps.payMethod != newViewProps.payMethod) {
+	_button.payMethod = AppYarnPackageViewString(toString(newViewProps.payMethod));
+  }
+
+  [super updateProps:props oldProps:oldProps];
+}
+
+- (void)prepareForRecycle
+{
+  [super prepareForRecycle];
+  // Keep the SDK button, only drop per-cell state so the next mount diffs
+  // against the defaults again.
+  [_button prepareForRecycle];
+  _button.color = nil;
+  _button.paymentRequest = nil;
+  _button.payMethod = nil;
+  _props = AppYarnPackageViewDefaultProps();
+}
+
+- (void)emitPaymentResult:(NSDictionary *)body
+{
+  if (!_eventEmitter) {
+	return;
+  }
+  std::static_pointer_cast<AppYarnPackageViewEventEmitter const>(_eventEmitter)
+	->onPaymentResult(AppYarnPackageViewEventEmitter::OnPaymentResult{
+	  .state = [body[@"state"] UTF8String],
+	  .info = [body[@"info"] UTF8String],
+	  .localSessionId = [body[@"localSessionId"] UTF8String],
+	});
+}
+
+@end
+
+Class<RCTComponentViewProtocol> AppYarnPackageViewCls(void)
+{
+  return AppYarnPackageView.class;
+}
+#endif
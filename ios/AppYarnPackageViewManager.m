@@ -8,6 +8,8 @@
 #import <React/RCTViewManager.h>
 #import <SPaySdk/SPaySdk.h>
 
+#import "AppYarnPackageButton.h"
+
 @interface AppYarnPackageViewManager : RCTViewManager
 @end
 
@@ -17,7 +19,12 @@ RCT_EXPORT_MODULE(AppYarnPackageView)
 
 - (UIView *)view
 {
-	return [[SBPButton alloc] init];
+	return [[AppYarnPackageButton alloc] init];
 }
 
+RCT_EXPORT_VIEW_PROPERTY(color, UIColor)
+RCT_EXPORT_VIEW_PROPERTY(paymentRequest, NSDictionary)
+RCT_EXPORT_VIEW_PROPERTY(payMethod, NSString)
+RCT_EXPORT_VIEW_PROPERTY(onPaymentResult, RCTDirectEventBlock)
+
 @end
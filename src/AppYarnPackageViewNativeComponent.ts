@@ -0,0 +1,34 @@
+import codegenNativeComponent from 'react-native/Libraries/Utilities/codegenNativeComponent';
+import type { ColorValue, ViewProps } from 'react-native';
+import type {
+  DirectEventHandler,
+  WithDefault,
+} from 'react-native/Libraries/Types/CodegenTypes';
+
+export type PaymentResultEvent = Readonly<{
+  state: string;
+  info: string;
+  localSessionId: string;
+}>;
+
+export interface NativeProps extends ViewProps {
+  color?: ColorValue;
+  // When set, a tap starts the SDK flow natively without a JS round trip and
+  // the outcome is reported through `onPaymentResult`. Such payments skip the
+  // stored outcomes of the pay functions; see `recordPaymentOutcome`.
+  paymentRequest?: Readonly<{
+    merchantLogin: string;
+    bankInvoiceId: string;
+    orderNumber: string;
+    language: string;
+    redirectUri: string;
+    apiKey: string;
+  }>;
+  payMethod?: WithDefault<
+    'bankInvoiceId' | 'withoutRefresh' | 'partPay',
+    'bankInvoiceId'
+  >;
+  onPaymentResult?: DirectEventHandler<PaymentResultEvent>;
+}
+
+export default codegenNativeComponent<NativeProps>('AppYarnPackageView');
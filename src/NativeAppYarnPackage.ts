@@ -0,0 +1,88 @@
+import type { TurboModule } from 'react-native';
+import { TurboModuleRegistry } from 'react-native';
+
+export type SPaySetupParams = {
+  bnplPlan: boolean;
+  resultViewNeeded: boolean;
+  helpers: boolean;
+  needLogs: boolean;
+  sbp: boolean;
+  creditCard: boolean;
+  debitCard: boolean;
+  // Android: hosts to resolve while the SDK initialises.
+  warmUpHosts?: string[];
+};
+
+export type SPayPaymentRequest = {
+  merchantLogin: string;
+  bankInvoiceId: string;
+  orderNumber: string;
+  language: string;
+  redirectUri: string;
+  apiKey: string;
+  sessionId?: string;
+  // iOS: let the SDK present itself instead of looking up the top view controller.
+  headless?: boolean;
+  // 'enqueue' (default), 'reject' or 'replace', see PaymentSchedulingPolicy.
+  policy?: string;
+  priority?: number;
+};
+
+export interface Spec extends TurboModule {
+  setupSDK(
+    params: SPaySetupParams,
+    environment: number,
+    callback: (errorString: string) => void
+  ): void;
+  isReadyForSPay(callback: (isReady: boolean) => void): void;
+  getStatus(callback: (status: Object) => void): void;
+  payWithBankInvoiceId(
+    params: SPayPaymentRequest,
+    // `code` is a PaymentResultCode, `category` a PaymentErrorCategory.
+    callback: (
+      code: number,
+      category: number,
+      info: string | null,
+      localSessionId: string | null,
+      trace: Object
+    ) => void
+  ): void;
+  payWithoutRefresh(
+    params: SPayPaymentRequest,
+    callback: (
+      code: number,
+      category: number,
+      info: string | null,
+      localSessionId: string | null,
+      trace: Object
+    ) => void
+  ): void;
+  payWithPartPay(
+    params: SPayPaymentRequest,
+    callback: (
+      code: number,
+      category: number,
+      info: string | null,
+      localSessionId: string | null,
+      trace: Object
+    ) => void
+  ): void;
+  cancelPayment(
+    sessionId: string,
+    callback: (cancelled: boolean) => void
+  ): void;
+  // Answers the session's pending callback with `code` and releases it.
+  abandonPayment(sessionId: string, code: number): void;
+  drainLatencyHistograms(callback: (histograms: string) => void): void;
+  installJSI(): boolean;
+  getStoredValue(
+    key: string,
+    callback: (value: string | null) => void
+  ): void;
+  setStoredValue(key: string, value: string | null): void;
+
+  addListener(eventName: string): void;
+  removeListeners(count: number): void;
+}
+
+export default TurboModuleRegistry.get<Spec>('AppYarnPackage');
@@ -0,0 +1,177 @@
+/**
+ * Per-call overhead of the JS wrappers against an in-memory native module.
+ * Run with `yarn bench`; results are printed as one JSON document on stdout,
+ * or written to the file named by `BENCH_OUTPUT`.
+ */
+import { writeFileSync } from 'fs';
+import { NativeModules } from 'react-native';
+
+const ITERATIONS = Number(process.env.BENCH_ITERATIONS ?? 5000);
+
+type Result = {
+  name: string;
+  iterations: number;
+  nsPerOp: number;
+  opsPerSec: number;
+  // Heap growth per call, only reported when node runs with --expose-gc.
+  bytesPerOp?: number;
+  p50Ns?: number;
+  p99Ns?: number;
+};
+
+type Callback = (...args: any[]) => void;
+
+// Answers synchronously like a native module that never blocks; `deferred`
+// holds callbacks the benchmark completes itself.
+const deferred: Array<() => void> = [];
+let deferPayments = false;
+const fakeModule = {
+  setupSDK: (_params: object, _environment: number, cb: Callback) => cb(null),
+  isReadyForSPay: (cb: Callback) => cb(true),
+  payWithBankInvoiceId: (_params: object, cb: Callback) => {
+    const reply = () => cb(0, 0, null, null, { received: 0, completed: 0.01 });
+    if (deferPayments) {
+      deferred.push(reply);
+    } else {
+      reply();
+    }
+  },
+  payWithoutRefresh: (_params: object, cb: Callback) =>
+    cb(0, 0, null, null, {}),
+  payWithPartPay: (_params: object, cb: Callback) => cb(0, 0, null, null, {}),
+  abandonPayment: () => {},
+  drainLatencyHistograms: (cb: Callback) => cb('[]'),
+  getStoredValue: (_key: string, cb: Callback) => cb(null),
+  setStoredValue: () => {},
+  installJSI: () => false,
+  addListener: () => {},
+  removeListeners: () => {},
+};
+NativeModules.AppYarnPackage = fakeModule;
+
+const lib = require('../index') as typeof import('../index');
+
+const gc: (() => void) | undefined = (global as any).gc;
+const results: Result[] = [];
+
+function now(): bigint {
+  return process.hrtime.bigint();
+}
+
+function heapUsed(): number {
+  gc?.();
+  return process.memoryUsage().heapUsed;
+}
+
+function record(
+  name: string,
+  iterations: number,
+  elapsed: bigint,
+  heap?: number
+) {
+  const nsPerOp = Number(elapsed) / iterations;
+  results.push({
+    name,
+    iterations,
+    nsPerOp,
+    opsPerSec: 1e9 / nsPerOp,
+    ...(gc && heap !== undefined ? { bytesPerOp: heap / iterations } : {}),
+  });
+}
+
+function measure(name: string, body: (i: number) => void) {
+  for (let i = 0; i < Math.min(ITERATIONS, 500); i++) {
+    body(i);
+  }
+  const heapBefore = heapUsed();
+  const start = now();
+  for (let i = 0; i < ITERATIONS; i++) {
+    body(i);
+  }
+  const elapsed = now() - start;
+  record(name, ITERATIONS, elapsed, heapUsed() - heapBefore);
+}
+
+function percentile(samples: number[], q: number): number {
+  const sorted = samples.slice().sort((a, b) => a - b);
+  return sorted[Math.floor(q * (sorted.length - 1))] as number;
+}
+
+function request(i: number) {
+  return {
+    merchantLogin: 'merchant',
+    bankInvoiceId: `invoice-${i}`,
+    orderNumber: '412',
+    language: 'RU',
+    redirectUri: 'app://spay',
+    apiKey: 'key',
+  };
+}
+
+const setupParams = {
+  bnplPlan: false,
+  resultViewNeeded: true,
+  helpers: true,
+  needLogs: false,
+  sbp: true,
+  creditCard: true,
+  debitCard: true,
+};
+
+afterAll(() => {
+  const output = JSON.stringify({ suite: 'js-wrapper', results });
+  if (process.env.BENCH_OUTPUT) {
+    writeFileSync(process.env.BENCH_OUTPUT, output);
+  } else {
+    process.stdout.write(`${output}\n`);
+  }
+});
+
+it('setupSDK with an unchanged config', () => {
+  measure('setupSDK.repeated', () => {
+    lib.setupSDK(setupParams, lib.SDKEnvironment.EnvironmentProd, () => {});
+  });
+});
+
+it('isReadyForSPay from the cached value', () => {
+  measure('isReadyForSPay.cached', () => {
+    lib.isReadyForSPay(() => {});
+  });
+});
+
+it('payWithBankInvoiceId round trip', () => {
+  measure('payWithBankInvoiceId.roundTrip', (i) => {
+    lib.payWithBankInvoiceId(request(i), () => {});
+  });
+});
+
+it('payWithBankInvoiceId callback delivery', () => {
+  deferPayments = true;
+  const latencies: number[] = [];
+  let reportedAt = now();
+  for (let i = 0; i < ITERATIONS; i++) {
+    lib.payWithBankInvoiceId(request(1_000_000 + i), () => {
+      latencies.push(Number(now() - reportedAt));
+    });
+  }
+  const start = now();
+  deferred.splice(0).forEach((reply) => {
+    reportedAt = now();
+    reply();
+  });
+  record('payWithBankInvoiceId.callbackDelivery', ITERATIONS, now() - start);
+  const result = results[results.length - 1] as Result;
+  result.p50Ns = percentile(latencies, 0.5);
+  result.p99Ns = percentile(latencies, 0.99);
+  deferPayments = false;
+});
+
+it('payWithBankInvoiceIdAsync throughput', async () => {
+  const start = now();
+  await Promise.all(
+    Array.from({ length: ITERATIONS }, (_, i) =>
+      lib.payWithBankInvoiceIdAsync(request(2_000_000 + i))
+    )
+  );
+  record('payWithBankInvoiceIdAsync.concurrent', ITERATIONS, now() - start);
+});
@@ -1,98 +1,211 @@
-import {
-  requireNativeComponent,
-  UIManager,
-  NativeModules,
-  Platform,
-  type ViewStyle,
-} from 'react-native';
+import { AppYarnPackage } from './native';
+import type { SPaySetupParams } from './NativeAppYarnPackage';
+import { preloadPaymentOutcomes } from './outcomes';
+
+export {
+  addSPayReadyListener,
+  ensureReadinessLoaded,
+  getSPayReady,
+  isReadyForSPay,
+  useSPayReady,
+} from './readiness';
+export { getStatus, type SDKStatus } from './status';
+export {
+  addPaymentStateListener,
+  waitForPaymentOutcome,
+  type PaymentState,
+  type PaymentStateEvent,
+} from './paymentEvents';
+export * from './payments';
+export {
+  forgetPendingPayment,
+  getPendingPayments,
+  setPaymentStatusResolver,
+  type PaymentStatusResolver,
+  type PendingPayment,
+} from './pending';
+export {
+  isRetryable,
+  PaymentErrorCategory,
+  PaymentResultCode,
+  type PaymentResult,
+} from './results';
+export {
+  clearPaymentOutcomes,
+  invalidatePaymentOutcome,
+  recordPaymentOutcome,
+} from './outcomes';
+export {
+  clearPaymentTokens,
+  getPaymentToken,
+  invalidatePaymentToken,
+  setPaymentTokenProvider,
+  type PaymentToken,
+  type PaymentTokenProvider,
+  type PaymentTokenRequest,
+} from './tokens';
+export {
+  drainLatencyHistograms,
+  type LatencyHistogramSummary,
+} from './metrics';
+export {
+  addTraceListener,
+  clearTraces,
+  getTraces,
+  type PaymentTrace,
+  type PaymentTraceMarks,
+  type PaymentTraceSpan,
+  type PaymentTraceStage,
+} from './tracing';
+export {
+  getSPayBridge,
+  installSPayBridge,
+  type SPayBridge,
+  type SPayBridgePaymentCallback,
+  type SPayBridgePaymentStateListener,
+} from './jsi';
+export {
+  default as AppYarnPackageView,
+  type NativeProps as AppYarnPackageViewProps,
+  type PaymentResultEvent as AppYarnPackageViewPaymentResultEvent,
+} from './AppYarnPackageViewNativeComponent';
 
 export enum SDKEnvironment {
 	EnvironmentProd = 0,
 	EnvironmentSandboxWithoutBankApp = 1,
-	EnvironmentSandboxRealBankApp = 2
+	EnvironmentSandboxRealBankApp = 2,
+	// Android debug builds only, or with AppYarnPackage_standInEnabled=true:
+	// payments are answered locally by a scripted stand-in instead of the SDK,
+	// for offline throughput and latency runs. Setup fails anywhere else.
+	EnvironmentStandIn = 3
 }
 
-const LINKING_ERROR =
-  `The package 'demo-project' doesn't seem to be linked. Make sure: \n\n` +
-  Platform.select({ ios: "- You have run 'pod install'\n", default: '' }) +
-  '- You rebuilt the app after installing the package\n' +
-  '- You are not using Expo Go\n';
+export type SetupParams = SPaySetupParams;
 
-  type AppYarnPackageViewProps = {
-    color: string;
-    style: ViewStyle;
-  };
-  
-  const ComponentName = 'AppYarnPackageView';
-    
-  export const AppYarnPackageView =
-    UIManager.getViewManagerConfig(ComponentName) != null
-        ? requireNativeComponent<AppYarnPackageViewProps>(ComponentName)
-        : () => {
-            throw new Error(LINKING_ERROR);
-          };
+type SetupCallback = (errorString: string) => void;
 
-const AppYarnPackage = NativeModules.AppYarnPackage
-  ? NativeModules.AppYarnPackage
-  : new Proxy(
-      {},
-      {
-        get() {
-          throw new Error(LINKING_ERROR);
-        },
-      }
-    );
+const SETUP_FLAGS: (keyof SetupParams)[] = [
+  'bnplPlan',
+  'resultViewNeeded',
+  'helpers',
+  'needLogs',
+  'sbp',
+  'creditCard',
+  'debitCard',
+];
 
-    export function setupSDK(params: {
-      bnplPlan: boolean,
-      resultViewNeeded: boolean,
-      helpers: boolean,
-      needLogs: boolean,
-      sbp: boolean,
-      creditCard: boolean,
-      debitCard: boolean
-    },
-    environment: SDKEnvironment,
-    fn: (errorString: string) => void) {
-  AppYarnPackage.setupSDK(params, environment, (errorString: string) => fn(errorString))
-}
+// The last init handed to the native module. While it is pending, callers with
+// the same config join `waiters`; once it has succeeded, identical re-calls are
+// answered from `result` without touching the SDK again.
+type SetupState = {
+  key: string;
+  waiters: SetupCallback[] | null;
+  result?: string;
+};
 
-export function isReadyForSPay(fn: (isReady: boolean) => void) {
-  AppYarnPackage.isReadyForSPay((event: boolean) => fn(event));
+let setupState: SetupState | null = null;
+
+function setupKey(params: SetupParams, environment: SDKEnvironment): string {
+  const flags = SETUP_FLAGS.map((flag) => (params[flag] ? 1 : 0)).join('');
+  return `${environment}:${flags}`;
 }
 
-export function payWithBankInvoiceId(requestParams: {
-                  merchantLogin: string, 
-                  bankInvoiceId: string,
-                  orderNumber: string,
-                  language: string,
-                  redirectUri: string
-                  apiKey: string
-                }, 
-                fn: (error: any, event: string) => void) {                    
-  AppYarnPackage.payWithBankInvoiceId(requestParams, (error: any, event: string) => fn(error, event))
+export function setupSDK(
+  params: SetupParams,
+  environment: SDKEnvironment,
+  fn: SetupCallback
+) {
+  preloadPaymentOutcomes();
+  const key = setupKey(params, environment);
+  const current = setupState;
+  if (current && current.key === key) {
+    if (current.waiters) {
+      current.waiters.push(fn);
+      return;
+    }
+    fn(current.result as string);
+    return;
+  }
+
+  const state: SetupState = { key, waiters: [fn] };
+  setupState = state;
+  AppYarnPackage.setupSDK(params, environment, (errorString: string) => {
+    const waiters = state.waiters ?? [];
+    state.waiters = null;
+    state.result = errorString;
+    if (errorString && setupState === state) {
+      // Forget failed inits so the next call retries instead of replaying the error.
+      setupState = null;
+    }
+    waiters.forEach((waiter) => waiter(errorString));
+  });
 }
 
-export function payWithoutRefresh(requestParams: {
-                merchantLogin: string, 
-                bankInvoiceId: string,
-                orderNumber: string,
-                language: string,
-                redirectUri: string
-                apiKey: string
-              }, 
-              fn: (error: any, event: string) => void) {
-  AppYarnPackage.payWithoutRefresh(requestParams, (error: any, event: string) => fn(error, event))
+export type SetupCallOptions = {
+  // Rejects with an `AbortError` when the signal fires.
+  signal?: AbortSignal;
+  // Rejects with a `TimeoutError` if the SDK hasn't answered by then.
+  timeoutMs?: number;
+};
+
+function setupAbandoned(name: 'TimeoutError' | 'AbortError'): Error {
+  const error = new Error(
+    name === 'TimeoutError' ? 'SDK setup timed out' : 'SDK setup was aborted'
+  );
+  error.name = name;
+  return error;
 }
 
-export function payWithPartPay(requestParams: {
-            merchantLogin: string, 
-            bankInvoiceId: string,
-            orderNumber: string,
-            language: string,
-            redirectUri: string
-            apiKey: string
-          }, 
-          fn: (error: any, event: string) => void) {
-  AppYarnPackage.payWithPartPay(requestParams,(error: any, event: string) => fn(error, event))
+export function setupSDKAsync(
+  params: SetupParams,
+  environment: SDKEnvironment,
+  options: SetupCallOptions = {}
+): Promise<void> {
+  const { signal, timeoutMs } = options;
+  return new Promise((resolve, reject) => {
+    if (signal?.aborted) {
+      reject(setupAbandoned('AbortError'));
+      return;
+    }
+    let timer: ReturnType<typeof setTimeout> | undefined;
+    const release = () => {
+      if (timer !== undefined) {
+        clearTimeout(timer);
+      }
+      signal?.removeEventListener('abort', onAbort);
+    };
+    const waiter: SetupCallback = (errorString: string) => {
+      release();
+      if (errorString) {
+        reject(new Error(errorString));
+      } else {
+        resolve();
+      }
+    };
+    // Only this caller stops waiting; the init itself keeps running and is
+    // joined or replayed by the next setupSDK call with the same config.
+    let state: SetupState | null = null;
+    const giveUp = (name: 'TimeoutError' | 'AbortError') => {
+      const waiters = state?.waiters;
+      const index = waiters ? waiters.indexOf(waiter) : -1;
+      if (!waiters || index < 0) {
+        return;
+      }
+      waiters.splice(index, 1);
+      release();
+      reject(setupAbandoned(name));
+    };
+    function onAbort() {
+      giveUp('AbortError');
+    }
+
+    setupSDK(params, environment, waiter);
+    if (setupState?.waiters?.includes(waiter)) {
+      state = setupState;
+      signal?.addEventListener('abort', onAbort);
+      if (timeoutMs !== undefined) {
+        timer = setTimeout(() => giveUp('TimeoutError'), timeoutMs);
+      }
+    }
+  });
 }
@@ -0,0 +1,84 @@
+import { AppYarnPackage } from './native';
+import type { PaymentRequestParams } from './payments';
+
+type SPayBridgePaymentState = 'waiting' | 'success' | 'error' | 'cancel';
+
+/** Called once, with the first state the payment reports. */
+export type SPayBridgePaymentCallback = (
+  state: SPayBridgePaymentState,
+  info: string,
+  localSessionId: string | null,
+  // A PaymentErrorCategory.
+  category: number
+) => void;
+
+/**
+ * Receives the states payments report after their first one, e.g. the final
+ * state of a payment that first reported `waiting`.
+ */
+export type SPayBridgePaymentStateListener = (
+  method: 'payWithBankInvoiceId' | 'payWithoutRefresh' | 'payWithPartPay',
+  bankInvoiceId: string,
+  state: SPayBridgePaymentState,
+  info: string,
+  localSessionId: string | null,
+  // A PaymentErrorCategory.
+  category: number
+) => void;
+
+/**
+ * JSI host object installed by the native module (see `cpp/SPayHostObject.h`).
+ * Calls pass arguments directly to C++ and `isReady` is answered synchronously.
+ * Payments made here skip the stored outcomes and the pending payment poller of
+ * the pay functions; record successes with `recordPaymentOutcome` to keep them.
+ */
+export type SPayBridge = {
+  readonly isReady: boolean;
+  setup(
+    params: Record<string, boolean>,
+    environment: number,
+    callback: (errorString: string | null) => void
+  ): void;
+  payWithBankInvoiceId(
+    request: PaymentRequestParams,
+    callback: SPayBridgePaymentCallback
+  ): void;
+  payWithoutRefresh(
+    request: PaymentRequestParams,
+    callback: SPayBridgePaymentCallback
+  ): void;
+  payWithPartPay(
+    request: PaymentRequestParams,
+    callback: SPayBridgePaymentCallback
+  ): void;
+  setPaymentStateListener(
+    listener: SPayBridgePaymentStateListener | null
+  ): void;
+};
+
+declare global {
+  // eslint-disable-next-line no-var
+  var __SPayBridge: SPayBridge | undefined;
+}
+
+let installAttempted = false;
+
+/**
+ * Installs the JSI bridge on first call and returns it, or `null` when the
+ * runtime doesn't support it (e.g. remote debugging).
+ */
+export function installSPayBridge(): SPayBridge | null {
+  if (!global.__SPayBridge && !installAttempted) {
+    installAttempted = true;
+    try {
+      AppYarnPackage.installJSI();
+    } catch {
+      // Synchronous native methods are unavailable, stay on the async bridge.
+    }
+  }
+  return global.__SPayBridge ?? null;
+}
+
+export function getSPayBridge(): SPayBridge | null {
+  return global.__SPayBridge ?? null;
+}
@@ -0,0 +1,30 @@
+import { AppYarnPackage } from './native';
+
+/**
+ * Summary of one native latency histogram. `name` is the operation
+ * (`setupSDK`, `isReadyForSPay`, `payWithBankInvoiceId`, ...) followed by the
+ * outcome, e.g. `payWithPartPay.waiting`; `isReadyForSPay` has no outcome.
+ * Percentiles are accurate to 12.5%.
+ */
+export type LatencyHistogramSummary = {
+  name: string;
+  count: number;
+  minMicros: number;
+  maxMicros: number;
+  meanMicros: number;
+  p50Micros: number;
+  p90Micros: number;
+  p99Micros: number;
+};
+
+/**
+ * Returns the latency histograms recorded natively since the previous drain
+ * and resets them. Only histograms with at least one sample are included.
+ */
+export function drainLatencyHistograms(): Promise<LatencyHistogramSummary[]> {
+  return new Promise((resolve) => {
+    AppYarnPackage.drainLatencyHistograms((histograms: string) => {
+      resolve(JSON.parse(histograms));
+    });
+  });
+}
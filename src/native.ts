@@ -0,0 +1,43 @@
+import { NativeEventEmitter, NativeModules, Platform } from 'react-native';
+import type { Spec } from './NativeAppYarnPackage';
+
+export const LINKING_ERROR =
+  `The package 'demo-project' doesn't seem to be linked. Make sure: \n\n` +
+  Platform.select({ ios: "- You have run 'pod install'\n", default: '' }) +
+  '- You rebuilt the app after installing the package\n' +
+  '- You are not using Expo Go\n';
+
+// @ts-expect-error
+const isTurboModuleEnabled = global.__turboModuleProxy != null;
+
+let nativeModule: Spec | null = null;
+
+// The module is looked up on first use rather than at import time, so apps
+// that never touch the SDK don't pay for loading it during startup.
+function resolveModule(): Spec {
+  if (!nativeModule) {
+    nativeModule = isTurboModuleEnabled
+      ? require('./NativeAppYarnPackage').default
+      : NativeModules.AppYarnPackage;
+    if (!nativeModule) {
+      throw new Error(LINKING_ERROR);
+    }
+  }
+  return nativeModule;
+}
+
+export const AppYarnPackage: Spec = new Proxy({} as Spec, {
+  get(_target, property) {
+    return resolveModule()[property as keyof Spec];
+  },
+});
+
+let eventEmitter: NativeEventEmitter | null = null;
+
+// Created on first use so importing the package never touches an unlinked module.
+export function getEventEmitter(): NativeEventEmitter {
+  if (!eventEmitter) {
+    eventEmitter = new NativeEventEmitter(AppYarnPackage);
+  }
+  return eventEmitter;
+}
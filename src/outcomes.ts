@@ -0,0 +1,237 @@
+import { AppYarnPackage } from './native';
+import {
+  addPaymentStateListener,
+  isFinalPaymentState,
+} from './paymentEvents';
+import {
+  PaymentErrorCategory,
+  PaymentResultCode,
+  type PaymentResult,
+} from './results';
+
+const STORE_KEY = 'paymentOutcomes';
+const OUTCOMES_LIMIT = 100;
+// How long a session abandoned by its callers is watched for a late success;
+// no SDK sheet stays open longer.
+const LATE_OUTCOME_WINDOW_MS = 60 * 60 * 1000;
+
+type OutcomeKey = {
+  orderNumber: string;
+  bankInvoiceId: string;
+};
+
+// Persisted as an array of entries, least recently used first.
+type StoredOutcome = OutcomeKey & {
+  result: PaymentResult;
+  completedAt: number;
+};
+
+// Completed payments by order and invoice, in LRU order. Only successes are
+// kept: paying again after a cancel or an error is what the user asked for,
+// paying twice for the same invoice never is. Filled by the pay wrappers in
+// payments.ts; payments made through `__SPayBridge` or the native button are
+// only known here when the app records them.
+const outcomes = new Map<string, StoredOutcome>();
+let loaded: Promise<void> | null = null;
+let isLoaded = false;
+
+function keyOf({ orderNumber, bankInvoiceId }: OutcomeKey): string {
+  return JSON.stringify([orderNumber, bankInvoiceId]);
+}
+
+// The persisted copy is read once per JS runtime; anything recorded in the
+// meantime counts as more recent.
+function loadPersisted(): Promise<void> {
+  if (!loaded) {
+    loaded = new Promise((resolve) => {
+      AppYarnPackage.getStoredValue(STORE_KEY, (value: string | null) => {
+        try {
+          const stored: StoredOutcome[] = value ? JSON.parse(value) : [];
+          const recent = Array.from(outcomes.values());
+          outcomes.clear();
+          stored.concat(recent).forEach((outcome) => {
+            const key = keyOf(outcome);
+            outcomes.delete(key);
+            outcomes.set(key, outcome);
+          });
+          trim();
+        } catch {
+          // A corrupt entry is rewritten with the next completed payment.
+        }
+        isLoaded = true;
+        resolve();
+      });
+    });
+  }
+  return loaded;
+}
+
+function trim() {
+  while (outcomes.size > OUTCOMES_LIMIT) {
+    const oldest = outcomes.keys().next().value;
+    if (oldest === undefined) {
+      break;
+    }
+    outcomes.delete(oldest);
+  }
+}
+
+function persist() {
+  AppYarnPackage.setStoredValue(
+    STORE_KEY,
+    outcomes.size > 0 ? JSON.stringify(Array.from(outcomes.values())) : null
+  );
+}
+
+/**
+ * Records a successful payment so later pay calls for the same order and
+ * invoice are answered from it. The pay functions do this themselves; call it
+ * for payments made through the JSI bridge or `AppYarnPackageView`.
+ */
+export function recordPaymentOutcome(
+  request: OutcomeKey,
+  result: PaymentResult
+) {
+  const key = keyOf(request);
+  if (outcomes.has(key)) {
+    return;
+  }
+  outcomes.set(key, {
+    orderNumber: request.orderNumber,
+    bankInvoiceId: request.bankInvoiceId,
+    result: {
+      code: result.code,
+      category: result.category,
+      sessionId: result.sessionId,
+      ...(result.localSessionId
+        ? { localSessionId: result.localSessionId }
+        : {}),
+    },
+    completedAt: Date.now(),
+  });
+  trim();
+  loadPersisted().then(persist);
+}
+
+/**
+ * Records the session's success, whether it reaches the pay callback or,
+ * after the caller timed out or aborted, only the payment state stream. The
+ * returned function takes the pay callback's result. A `waiting` result hands
+ * the session over to pending.ts, which records its success itself; without
+ * any result the stream is watched for `LATE_OUTCOME_WINDOW_MS` at most.
+ */
+export function trackPaymentOutcome(
+  sessionId: string,
+  request: OutcomeKey
+): (result: PaymentResult) => void {
+  const stop = () => {
+    clearTimeout(expiry);
+    unsubscribe();
+  };
+  const unsubscribe = addPaymentStateListener((event) => {
+    if (!isFinalPaymentState(event.state)) {
+      return;
+    }
+    stop();
+    if (event.state === 'success') {
+      recordPaymentOutcome(request, {
+        code: PaymentResultCode.Success,
+        category: PaymentErrorCategory.None,
+        sessionId,
+        localSessionId: event.localSessionId,
+      });
+    }
+  }, sessionId);
+  const expiry = setTimeout(stop, LATE_OUTCOME_WINDOW_MS);
+  return (result) => {
+    switch (result.code) {
+      case PaymentResultCode.Success:
+        recordPaymentOutcome(request, result);
+        stop();
+        break;
+      case PaymentResultCode.Waiting:
+      case PaymentResultCode.Cancel:
+      case PaymentResultCode.Error:
+        stop();
+        break;
+      default:
+        // The SDK may still finish the payment.
+        break;
+    }
+  };
+}
+
+/**
+ * Starts reading the persisted outcomes, so the first pay call doesn't wait
+ * for them. Called by setupSDK.
+ */
+export function preloadPaymentOutcomes() {
+  loadPersisted();
+}
+
+/**
+ * Whether the persisted outcomes have been read, i.e. whether
+ * `findLoadedPaymentOutcome` answers for them too.
+ */
+export function paymentOutcomesLoaded(): boolean {
+  return isLoaded;
+}
+
+/**
+ * Returns the stored result of a completed payment for the order and invoice
+ * from memory, marking it as most recently used.
+ */
+export function findLoadedPaymentOutcome(
+  request: OutcomeKey
+): PaymentResult | undefined {
+  const key = keyOf(request);
+  const outcome = outcomes.get(key);
+  if (!outcome) {
+    return undefined;
+  }
+  outcomes.delete(key);
+  outcomes.set(key, outcome);
+  return outcome.result;
+}
+
+/**
+ * Resolves with the stored result of a completed payment for the order and
+ * invoice, marking it as most recently used.
+ */
+export function findPaymentOutcome(
+  request: OutcomeKey
+): Promise<PaymentResult | undefined> {
+  return loadPersisted().then(() => findLoadedPaymentOutcome(request));
+}
+
+/**
+ * Forgets the completed payments of an order, or only the one for
+ * `bankInvoiceId`, so the next pay call for it reaches the SDK again.
+ */
+export function invalidatePaymentOutcome(
+  orderNumber: string,
+  bankInvoiceId?: string
+): Promise<void> {
+  return loadPersisted().then(() => {
+    let changed = false;
+    outcomes.forEach((outcome, key) => {
+      if (
+        outcome.orderNumber === orderNumber &&
+        (bankInvoiceId === undefined || outcome.bankInvoiceId === bankInvoiceId)
+      ) {
+        outcomes.delete(key);
+        changed = true;
+      }
+    });
+    if (changed) {
+      persist();
+    }
+  });
+}
+
+export function clearPaymentOutcomes(): Promise<void> {
+  return loadPersisted().then(() => {
+    outcomes.clear();
+    AppYarnPackage.setStoredValue(STORE_KEY, null);
+  });
+}
@@ -0,0 +1,104 @@
+import { getEventEmitter } from './native';
+
+const PAYMENT_STATE_EVENT = 'AppYarnPackagePaymentStateChanged';
+const RECENT_SESSIONS_LIMIT = 32;
+
+export type PaymentState = 'waiting' | 'success' | 'error' | 'cancel';
+
+export type PaymentStateEvent = {
+  sessionId: string;
+  state: PaymentState;
+  info?: string;
+  localSessionId?: string;
+};
+
+type PaymentStateListener = (event: PaymentStateEvent) => void;
+
+// Latest state per session, so a listener attached after the native event has
+// already arrived (e.g. right after the pay callback fired) still sees it.
+const recentStates = new Map<string, PaymentStateEvent>();
+const listeners = new Set<PaymentStateListener>();
+let subscribed = false;
+let sessionCounter = 0;
+
+// Delivers a state to listeners as if the native module had emitted it; the
+// pending payment poller reports the states it resolves this way.
+export function reportPaymentState(event: PaymentStateEvent) {
+  recentStates.delete(event.sessionId);
+  recentStates.set(event.sessionId, event);
+  if (recentStates.size > RECENT_SESSIONS_LIMIT) {
+    const oldest = recentStates.keys().next().value;
+    if (oldest !== undefined) {
+      recentStates.delete(oldest);
+    }
+  }
+  listeners.forEach((listener) => listener(event));
+}
+
+export function ensurePaymentStateSubscribed() {
+  if (subscribed) {
+    return;
+  }
+  subscribed = true;
+  getEventEmitter().addListener(PAYMENT_STATE_EVENT, reportPaymentState);
+}
+
+export function nextSessionId(): string {
+  sessionCounter += 1;
+  return `${Date.now().toString(36)}-${sessionCounter}`;
+}
+
+export function isFinalPaymentState(state: PaymentState): boolean {
+  return state !== 'waiting';
+}
+
+/**
+ * Subscribes to payment state transitions. When `sessionId` is given only that
+ * session's events are delivered, starting with its latest known state.
+ */
+export function addPaymentStateListener(
+  listener: PaymentStateListener,
+  sessionId?: string
+): () => void {
+  ensurePaymentStateSubscribed();
+  const filtered: PaymentStateListener =
+    sessionId === undefined
+      ? listener
+      : (event) => {
+          if (event.sessionId === sessionId) {
+            listener(event);
+          }
+        };
+  listeners.add(filtered);
+  const latest = sessionId === undefined ? undefined : recentStates.get(sessionId);
+  if (latest) {
+    listener(latest);
+  }
+  return () => {
+    listeners.delete(filtered);
+  };
+}
+
+/**
+ * Resolves with the first success/error/cancel event of a session, so callers
+ * that got `waiting` back don't need to poll the backend for the outcome.
+ */
+export function waitForPaymentOutcome(
+  sessionId: string
+): Promise<PaymentStateEvent> {
+  return new Promise((resolve) => {
+    let unsubscribe: (() => void) | null = null;
+    let settled = false;
+    unsubscribe = addPaymentStateListener((event) => {
+      if (settled || !isFinalPaymentState(event.state)) {
+        return;
+      }
+      settled = true;
+      unsubscribe?.();
+      resolve(event);
+    }, sessionId);
+    if (settled) {
+      unsubscribe();
+    }
+  });
+}
@@ -0,0 +1,345 @@
+import { AppYarnPackage } from './native';
+import type { SPayPaymentRequest } from './NativeAppYarnPackage';
+import {
+  findLoadedPaymentOutcome,
+  findPaymentOutcome,
+  paymentOutcomesLoaded,
+  trackPaymentOutcome,
+} from './outcomes';
+import { ensurePaymentStateSubscribed, nextSessionId } from './paymentEvents';
+import { trackPendingPayment } from './pending';
+import {
+  PaymentErrorCategory,
+  PaymentResultCode,
+  statusOf,
+  type PaymentResult,
+} from './results';
+import { monotonicNow, recordPaymentTrace } from './tracing';
+
+/**
+ * What happens to a payment started while another payment's sheet is on
+ * screen: wait for it (`enqueue`), fail right away (`reject`), or drop the
+ * payments already waiting and go next (`replace`). The sheet on screen is
+ * never interrupted. Waiting payments with a higher `priority` start first.
+ */
+export type PaymentSchedulingPolicy = 'enqueue' | 'reject' | 'replace';
+
+export type PaymentRequestParams = Omit<
+  SPayPaymentRequest,
+  'sessionId' | 'policy'
+> & {
+  policy?: PaymentSchedulingPolicy;
+};
+
+/**
+ * `timeout` and `aborted` are settled locally by `PaymentCallOptions`; the SDK
+ * may still finish the payment, which `addPaymentStateListener` reports. Its
+ * sheet keeps the payment slot until then, or for a minute at most, so
+ * payments started meanwhile wait for it as usual.
+ */
+export type PaymentStatus =
+  | 'success'
+  | 'waiting'
+  | 'cancel'
+  | 'timeout'
+  | 'aborted';
+
+export type PaymentCallOptions = {
+  // Settles the call with `aborted` when the signal fires.
+  signal?: AbortSignal;
+  // Settles the call with `timeout` if the SDK hasn't answered by then.
+  timeoutMs?: number;
+};
+
+type PaymentMethod =
+  | 'payWithBankInvoiceId'
+  | 'payWithoutRefresh'
+  | 'payWithPartPay';
+type ResultCallback = (result: PaymentResult) => void;
+
+/**
+ * `error` is the SDK's message for `Error` results and `null` otherwise,
+ * `event` the status or, for errors, the message again. Classify failures by
+ * `result` instead of matching on either string.
+ */
+export type PaymentCallback = (
+  error: string | null,
+  event: string,
+  result: PaymentResult
+) => void;
+
+export class PaymentError extends Error {
+  readonly info: string;
+  readonly result: PaymentResult;
+
+  constructor(result: PaymentResult) {
+    super(result.info || 'The payment failed');
+    this.name = 'PaymentError';
+    this.info = result.info || 'error';
+    this.result = result;
+  }
+}
+
+type Waiter = {
+  fn: ResultCallback;
+  release: () => void;
+};
+
+type InFlightPayment = {
+  sessionId: string;
+  waiters: Waiter[];
+  // Whether the native call was made, i.e. no stored outcome answered it.
+  started: boolean;
+};
+
+// Callers waiting on the native call currently in flight, by pay method and
+// bankInvoiceId. A second tap for the same invoice and method joins the
+// existing entry instead of opening another SDK sheet, and the single native
+// result is fanned out to all of them. Paying in parts is a different payment.
+const inFlightPayments = new Map<string, InFlightPayment>();
+
+function settle(waiters: Waiter[], result: PaymentResult) {
+  waiters.forEach((waiter) => {
+    waiter.release();
+    waiter.fn(result);
+  });
+}
+
+// Arms the caller's timeout and abort signal. Settling one caller early
+// leaves the others waiting; once nobody is left the native side is told to
+// answer its callback now, so neither side keeps the call's closures alive.
+function addWaiter(
+  key: string,
+  payment: InFlightPayment,
+  fn: ResultCallback,
+  options: PaymentCallOptions
+) {
+  const { signal, timeoutMs } = options;
+  let timer: ReturnType<typeof setTimeout> | undefined;
+  const waiter: Waiter = {
+    fn,
+    release: () => {
+      if (timer !== undefined) {
+        clearTimeout(timer);
+      }
+      signal?.removeEventListener('abort', onAbort);
+    },
+  };
+  const giveUp = (
+    code: PaymentResultCode.Timeout | PaymentResultCode.Aborted
+  ) => {
+    const index = payment.waiters.indexOf(waiter);
+    if (index < 0) {
+      return;
+    }
+    payment.waiters.splice(index, 1);
+    if (payment.waiters.length === 0 && inFlightPayments.get(key) === payment) {
+      inFlightPayments.delete(key);
+      if (payment.started) {
+        AppYarnPackage.abandonPayment(payment.sessionId, code);
+      }
+    }
+    settle([waiter], {
+      code,
+      category: PaymentErrorCategory.None,
+      sessionId: payment.sessionId,
+    });
+  };
+  function onAbort() {
+    giveUp(PaymentResultCode.Aborted);
+  }
+
+  payment.waiters.push(waiter);
+  if (signal?.aborted) {
+    giveUp(PaymentResultCode.Aborted);
+    return;
+  }
+  signal?.addEventListener('abort', onAbort);
+  if (timeoutMs !== undefined) {
+    timer = setTimeout(() => giveUp(PaymentResultCode.Timeout), timeoutMs);
+  }
+}
+
+function startPayment(
+  method: PaymentMethod,
+  requestParams: PaymentRequestParams,
+  key: string,
+  payment: InFlightPayment
+) {
+  const { sessionId } = payment;
+  const startedAt = monotonicNow();
+  const recordOutcome = trackPaymentOutcome(sessionId, requestParams);
+  payment.started = true;
+  AppYarnPackage[method](
+    { ...requestParams, sessionId },
+    (
+      code: number,
+      category: number,
+      info: string | null,
+      localSessionId: string | null,
+      trace?: Object
+    ) => {
+      recordPaymentTrace(sessionId, method, statusOf(code), startedAt, trace);
+      if (inFlightPayments.get(key) === payment) {
+        inFlightPayments.delete(key);
+      }
+      const result: PaymentResult = { code, category, sessionId };
+      if (localSessionId) {
+        result.localSessionId = localSessionId;
+      }
+      if (info) {
+        result.info = info;
+      }
+      recordOutcome(result);
+      if (code === PaymentResultCode.Waiting) {
+        trackPendingPayment(requestParams, sessionId, result.localSessionId);
+      }
+      settle(payment.waiters.splice(0), result);
+    }
+  );
+}
+
+// Returns the session id under which the payment's state transitions are
+// streamed; joined calls share the session of the call already in flight.
+// An order and invoice that were already paid for are answered from the
+// stored outcome, with `cached` set, without reaching the SDK.
+function invokePayment(
+  method: PaymentMethod,
+  requestParams: PaymentRequestParams,
+  fn: ResultCallback,
+  options: PaymentCallOptions = {}
+): string {
+  const key = `${method}:${requestParams.bankInvoiceId}`;
+  const pending = inFlightPayments.get(key);
+  if (pending) {
+    addWaiter(key, pending, fn, options);
+    return pending.sessionId;
+  }
+  ensurePaymentStateSubscribed();
+  const sessionId = nextSessionId();
+  const payment: InFlightPayment = { sessionId, waiters: [], started: false };
+  inFlightPayments.set(key, payment);
+  addWaiter(key, payment, fn, options);
+  // Once the stored outcomes are in memory an unpaid invoice goes straight to
+  // the SDK; only a stored result is still delivered asynchronously.
+  if (paymentOutcomesLoaded() && !findLoadedPaymentOutcome(requestParams)) {
+    startPayment(method, requestParams, key, payment);
+    return sessionId;
+  }
+  findPaymentOutcome(requestParams).then((stored) => {
+    // Every caller gave up while the stored outcomes were read.
+    if (inFlightPayments.get(key) !== payment) {
+      return;
+    }
+    if (!stored) {
+      startPayment(method, requestParams, key, payment);
+      return;
+    }
+    inFlightPayments.delete(key);
+    settle(payment.waiters.splice(0), { ...stored, sessionId, cached: true });
+  });
+  return sessionId;
+}
+
+function toCallback(fn: PaymentCallback): ResultCallback {
+  return (result) => {
+    if (result.code === PaymentResultCode.Error) {
+      const message = result.info || 'error';
+      fn(message, message, result);
+    } else {
+      fn(null, statusOf(result.code), result);
+    }
+  };
+}
+
+function invokePaymentAsync(
+  method: PaymentMethod,
+  requestParams: PaymentRequestParams,
+  options?: PaymentCallOptions
+): Promise<PaymentStatus> {
+  return new Promise((resolve, reject) => {
+    invokePayment(
+      method,
+      requestParams,
+      (result) => {
+        if (result.code === PaymentResultCode.Error) {
+          reject(new PaymentError(result));
+        } else {
+          resolve(statusOf(result.code) as PaymentStatus);
+        }
+      },
+      options
+    );
+  });
+}
+
+export function payWithBankInvoiceId(
+  requestParams: PaymentRequestParams,
+  fn: PaymentCallback,
+  options?: PaymentCallOptions
+): string {
+  return invokePayment(
+    'payWithBankInvoiceId',
+    requestParams,
+    toCallback(fn),
+    options
+  );
+}
+
+export function payWithoutRefresh(
+  requestParams: PaymentRequestParams,
+  fn: PaymentCallback,
+  options?: PaymentCallOptions
+): string {
+  return invokePayment(
+    'payWithoutRefresh',
+    requestParams,
+    toCallback(fn),
+    options
+  );
+}
+
+export function payWithPartPay(
+  requestParams: PaymentRequestParams,
+  fn: PaymentCallback,
+  options?: PaymentCallOptions
+): string {
+  return invokePayment(
+    'payWithPartPay',
+    requestParams,
+    toCallback(fn),
+    options
+  );
+}
+
+export function payWithBankInvoiceIdAsync(
+  requestParams: PaymentRequestParams,
+  options?: PaymentCallOptions
+): Promise<PaymentStatus> {
+  return invokePaymentAsync('payWithBankInvoiceId', requestParams, options);
+}
+
+export function payWithoutRefreshAsync(
+  requestParams: PaymentRequestParams,
+  options?: PaymentCallOptions
+): Promise<PaymentStatus> {
+  return invokePaymentAsync('payWithoutRefresh', requestParams, options);
+}
+
+export function payWithPartPayAsync(
+  requestParams: PaymentRequestParams,
+  options?: PaymentCallOptions
+): Promise<PaymentStatus> {
+  return invokePaymentAsync('payWithPartPay', requestParams, options);
+}
+
+/**
+ * Cancels a payment that is still waiting for another sheet to close; its
+ * callback receives `cancel`. Resolves to `false` once the payment's sheet is
+ * on screen, which only the user can dismiss.
+ */
+export function cancelPayment(sessionId: string): Promise<boolean> {
+  return new Promise((resolve) => {
+    AppYarnPackage.cancelPayment(sessionId, resolve);
+  });
+}
@@ -0,0 +1,248 @@
+import { AppYarnPackage } from './native';
+import { recordPaymentOutcome } from './outcomes';
+import {
+  addPaymentStateListener,
+  isFinalPaymentState,
+  reportPaymentState,
+  type PaymentState,
+  type PaymentStateEvent,
+} from './paymentEvents';
+import { PaymentErrorCategory, PaymentResultCode, statusOf } from './results';
+
+const STORE_KEY = 'pendingPayments';
+const BATCH_LIMIT = 20;
+const FIRST_POLL_DELAY_MS = 2000;
+const MAX_POLL_DELAY_MS = 5 * 60 * 1000;
+// Payments still waiting after this long are left to the app's own
+// reconciliation.
+const MAX_PENDING_AGE_MS = 24 * 60 * 60 * 1000;
+
+/**
+ * A payment that ended in `waiting`, tracked until the SDK or the resolver
+ * reports its final state. Times are `Date.now()` values, so they survive an
+ * app restart.
+ */
+export type PendingPayment = {
+  sessionId: string;
+  orderNumber: string;
+  bankInvoiceId: string;
+  // The SDK's own id of the payment session, when it reported one (iOS).
+  localSessionId?: string;
+  since: number;
+  attempts: number;
+  nextPollAt: number;
+};
+
+/**
+ * Looks up the final state of a batch of waiting payments, e.g. with one
+ * request to the merchant backend. Payments missing from the result, or
+ * reported as `Waiting`, are asked about again later.
+ */
+export type PaymentStatusResolver = (
+  payments: PendingPayment[]
+) => Promise<Record<string, PaymentResultCode>>;
+
+// Waiting payments by sessionId, persisted on every change.
+const pending = new Map<string, PendingPayment>();
+let resolver: PaymentStatusResolver | null = null;
+let loaded: Promise<void> | null = null;
+let timer: ReturnType<typeof setTimeout> | undefined;
+let polling = false;
+let subscribed = false;
+
+function loadPersisted(): Promise<void> {
+  if (!loaded) {
+    loaded = new Promise((resolve) => {
+      AppYarnPackage.getStoredValue(STORE_KEY, (value: string | null) => {
+        try {
+          const stored: PendingPayment[] = value ? JSON.parse(value) : [];
+          stored.forEach((payment) => {
+            if (!pending.has(payment.sessionId)) {
+              pending.set(payment.sessionId, payment);
+            }
+          });
+        } catch {
+          // A corrupt entry is rewritten with the next change.
+        }
+        resolve();
+      });
+    });
+  }
+  return loaded;
+}
+
+function persist() {
+  AppYarnPackage.setStoredValue(
+    STORE_KEY,
+    pending.size > 0 ? JSON.stringify(Array.from(pending.values())) : null
+  );
+}
+
+// The SDK itself may still report the final state while the app runs.
+function onPaymentState(event: PaymentStateEvent) {
+  const payment = pending.get(event.sessionId);
+  if (!payment || !isFinalPaymentState(event.state)) {
+    return;
+  }
+  pending.delete(event.sessionId);
+  if (event.state === 'success') {
+    recordPaymentOutcome(payment, {
+      code: PaymentResultCode.Success,
+      category: PaymentErrorCategory.None,
+      sessionId: payment.sessionId,
+      localSessionId: event.localSessionId ?? payment.localSessionId,
+    });
+  }
+  loadPersisted().then(persist);
+}
+
+function ensureSubscribed() {
+  if (!subscribed) {
+    subscribed = true;
+    addPaymentStateListener(onPaymentState);
+  }
+}
+
+// Unanswered polls are retried after 2s, 4s, 8s, ... up to MAX_POLL_DELAY_MS.
+function backOff(payment: PendingPayment, now: number) {
+  const delay = FIRST_POLL_DELAY_MS * 2 ** payment.attempts;
+  payment.attempts += 1;
+  payment.nextPollAt = now + Math.min(delay, MAX_POLL_DELAY_MS);
+}
+
+function schedule() {
+  if (timer !== undefined) {
+    clearTimeout(timer);
+    timer = undefined;
+  }
+  if (!resolver || polling || pending.size === 0) {
+    return;
+  }
+  let next = Infinity;
+  pending.forEach((payment) => {
+    next = Math.min(next, payment.nextPollAt);
+  });
+  timer = setTimeout(poll, Math.max(0, next - Date.now()));
+}
+
+// One resolver call per tick for the payments that are due, oldest first.
+function poll() {
+  timer = undefined;
+  const resolve = resolver;
+  if (!resolve) {
+    return;
+  }
+  const now = Date.now();
+  pending.forEach((payment, sessionId) => {
+    if (now - payment.since > MAX_PENDING_AGE_MS) {
+      pending.delete(sessionId);
+    }
+  });
+  const due = Array.from(pending.values())
+    .filter((payment) => payment.nextPollAt <= now)
+    .sort((a, b) => a.since - b.since)
+    .slice(0, BATCH_LIMIT);
+  if (due.length === 0) {
+    persist();
+    schedule();
+    return;
+  }
+  polling = true;
+  resolve(due.map((payment) => ({ ...payment })))
+    .catch(() => ({}) as Record<string, PaymentResultCode>)
+    .then((codes) => {
+      polling = false;
+      const answeredAt = Date.now();
+      due.forEach((payment) => {
+        if (pending.get(payment.sessionId) !== payment) {
+          return;
+        }
+        const code = codes[payment.sessionId];
+        if (
+          code === PaymentResultCode.Success ||
+          code === PaymentResultCode.Cancel ||
+          code === PaymentResultCode.Error
+        ) {
+          settlePending(payment, code);
+        } else {
+          backOff(payment, answeredAt);
+        }
+      });
+      persist();
+      schedule();
+    });
+}
+
+function settlePending(payment: PendingPayment, code: PaymentResultCode) {
+  pending.delete(payment.sessionId);
+  if (code === PaymentResultCode.Success) {
+    recordPaymentOutcome(payment, {
+      code,
+      category: PaymentErrorCategory.None,
+      sessionId: payment.sessionId,
+      localSessionId: payment.localSessionId,
+    });
+  }
+  reportPaymentState({
+    sessionId: payment.sessionId,
+    state: statusOf(code) as PaymentState,
+    localSessionId: payment.localSessionId,
+  });
+}
+
+/**
+ * Starts tracking a payment that the pay callback reported as `waiting`.
+ */
+export function trackPendingPayment(
+  request: { orderNumber: string; bankInvoiceId: string },
+  sessionId: string,
+  localSessionId?: string
+) {
+  ensureSubscribed();
+  const now = Date.now();
+  const payment: PendingPayment = {
+    sessionId,
+    orderNumber: request.orderNumber,
+    bankInvoiceId: request.bankInvoiceId,
+    since: now,
+    attempts: 0,
+    nextPollAt: now + FIRST_POLL_DELAY_MS,
+  };
+  if (localSessionId) {
+    payment.localSessionId = localSessionId;
+  }
+  pending.set(sessionId, payment);
+  loadPersisted().then(() => {
+    persist();
+    schedule();
+  });
+}
+
+/**
+ * Sets the resolver the poller asks about waiting payments, including those
+ * left over from earlier app runs, and starts polling. Final states are
+ * delivered to `addPaymentStateListener` and `waitForPaymentOutcome`.
+ */
+export function setPaymentStatusResolver(next: PaymentStatusResolver | null) {
+  resolver = next;
+  ensureSubscribed();
+  loadPersisted().then(schedule);
+}
+
+export function getPendingPayments(): Promise<PendingPayment[]> {
+  return loadPersisted().then(() =>
+    Array.from(pending.values(), (payment) => ({ ...payment }))
+  );
+}
+
+/**
+ * Stops tracking a payment, e.g. once the app learnt its outcome elsewhere.
+ */
+export function forgetPendingPayment(sessionId: string): Promise<void> {
+  return loadPersisted().then(() => {
+    if (pending.delete(sessionId)) {
+      persist();
+      schedule();
+    }
+  });
+}
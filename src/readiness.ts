@@ -0,0 +1,98 @@
+import { useSyncExternalStore } from 'react';
+import { getSPayBridge } from './jsi';
+import { AppYarnPackage, getEventEmitter } from './native';
+
+const READINESS_EVENT = 'AppYarnPackageReadinessChanged';
+
+type ReadinessListener = (isReady: boolean) => void;
+
+// Last readiness value reported by the native side. Native code pushes a new
+// value only when it can actually change (package add/remove on Android, app
+// foregrounding on iOS, a finished setupSDK), so reads never cross the bridge.
+let readiness: boolean | undefined;
+let subscribed = false;
+let loading = false;
+const listeners = new Set<ReadinessListener>();
+
+function updateReadiness(isReady: boolean) {
+  if (readiness === isReady) {
+    return;
+  }
+  readiness = isReady;
+  listeners.forEach((listener) => listener(isReady));
+}
+
+function ensureSubscribed() {
+  if (subscribed) {
+    return;
+  }
+  subscribed = true;
+  getEventEmitter().addListener(
+    READINESS_EVENT,
+    (event: { isReady: boolean }) => updateReadiness(event.isReady)
+  );
+}
+
+// Feeds a readiness value read by another native call, e.g. `getStatus`.
+export function reportSPayReady(isReady: boolean) {
+  ensureSubscribed();
+  updateReadiness(isReady);
+}
+
+function refreshReadiness(fn?: ReadinessListener) {
+  AppYarnPackage.isReadyForSPay((isReady: boolean) => {
+    updateReadiness(isReady);
+    fn?.(isReady);
+  });
+}
+
+/**
+ * Subscribes to native readiness changes and fetches the first value if it
+ * hasn't been reported yet. `addSPayReadyListener` calls it.
+ */
+export function ensureReadinessLoaded() {
+  ensureSubscribed();
+  if (readiness !== undefined || loading) {
+    return;
+  }
+  const bridge = getSPayBridge();
+  if (bridge) {
+    updateReadiness(bridge.isReady);
+    return;
+  }
+  loading = true;
+  refreshReadiness(() => {
+    loading = false;
+  });
+}
+
+/**
+ * Returns the cached readiness value, or `undefined` until the native side has
+ * reported it for the first time. Never calls into native code, so it is safe
+ * as a `useSyncExternalStore` snapshot; see `ensureReadinessLoaded`.
+ */
+export function getSPayReady(): boolean | undefined {
+  return readiness;
+}
+
+export function addSPayReadyListener(listener: ReadinessListener): () => void {
+  listeners.add(listener);
+  ensureReadinessLoaded();
+  return () => {
+    listeners.delete(listener);
+  };
+}
+
+export function isReadyForSPay(fn: (isReady: boolean) => void) {
+  ensureSubscribed();
+  if (readiness !== undefined) {
+    fn(readiness);
+    return;
+  }
+  refreshReadiness(fn);
+}
+
+// useSyncExternalStore is why the package needs React 18 or later.
+export function useSPayReady(): boolean | undefined {
+  return useSyncExternalStore(addSPayReadyListener, getSPayReady);
+}
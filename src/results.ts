@@ -0,0 +1,71 @@
+/**
+ * Outcome of a payment call. The first four codes are the SDK's states,
+ * `Timeout` and `Aborted` are settled by `PaymentCallOptions`.
+ */
+export enum PaymentResultCode {
+  Success = 0,
+  Waiting = 1,
+  Cancel = 2,
+  Error = 3,
+  Timeout = 4,
+  Aborted = 5,
+}
+
+// Mirrors spaybridge::ErrorCategory in cpp/SPayBridge.h.
+export enum PaymentErrorCategory {
+  None = 0,
+  // The SDK reported an error.
+  Sdk = 1,
+  // There was no screen to present the payment sheet from.
+  Presentation = 2,
+  // Another payment's sheet kept this one from starting.
+  Scheduling = 3,
+  // The request never reached the SDK, e.g. it was malformed.
+  Internal = 4,
+}
+
+export type PaymentResult = {
+  code: PaymentResultCode;
+  category: PaymentErrorCategory;
+  sessionId: string;
+  // The SDK's own id of the payment session, when it reported one.
+  localSessionId?: string;
+  // The SDK's message, for logs only.
+  info?: string;
+  // The order was already paid for; `localSessionId` is the earlier payment's.
+  cached?: boolean;
+};
+
+const STATUS_NAMES = [
+  'success',
+  'waiting',
+  'cancel',
+  'error',
+  'timeout',
+  'aborted',
+] as const;
+
+export type PaymentResultStatus = (typeof STATUS_NAMES)[number];
+
+export function statusOf(code: PaymentResultCode): PaymentResultStatus {
+  return STATUS_NAMES[code] ?? 'error';
+}
+
+/**
+ * Whether trying the same payment again can succeed without the user's
+ * involvement: it never reached the SDK's sheet. Cancellations and the SDK's
+ * own errors are final. `Timeout` and `Aborted` are not retryable either: the
+ * sheet may still be on screen, or the user in the bank app, so wait for the
+ * session's final state with `waitForPaymentOutcome` instead.
+ */
+export function isRetryable(result: PaymentResult): boolean {
+  switch (result.code) {
+    case PaymentResultCode.Error:
+      return (
+        result.category === PaymentErrorCategory.Presentation ||
+        result.category === PaymentErrorCategory.Scheduling
+      );
+    default:
+      return false;
+  }
+}
@@ -0,0 +1,34 @@
+import { AppYarnPackage } from './native';
+import type { SPaySetupParams } from './NativeAppYarnPackage';
+import { reportSPayReady } from './readiness';
+
+/**
+ * Snapshot of the native SDK state. `environment` and `config` describe the
+ * last setupSDK call and are absent while `initState` is `idle`.
+ */
+export type SDKStatus = {
+  initState: 'idle' | 'pending' | 'ready' | 'failed';
+  initError?: string;
+  isReady: boolean;
+  // An SDKEnvironment value.
+  environment?: number;
+  // The flags setupSDK was called with, including the enabled helpers.
+  config?: SPaySetupParams;
+  sdkVersion: string;
+  // Whether the fingerprint library was preloaded after setup (Android).
+  fingerprint?: 'idle' | 'pending' | 'ready' | 'failed';
+};
+
+/**
+ * Reads init state, readiness, environment, helpers and SDK version in one
+ * bridge round trip. The readiness value also refreshes `getSPayReady`.
+ */
+export function getStatus(): Promise<SDKStatus> {
+  return new Promise((resolve) => {
+    AppYarnPackage.getStatus((status: Object) => {
+      const snapshot = status as SDKStatus;
+      reportSPayReady(snapshot.isReady);
+      resolve(snapshot);
+    });
+  });
+}
@@ -0,0 +1,135 @@
+import { AppYarnPackage } from './native';
+
+// Mirrors `SPaymentTokenRequest` from the SDK header.
+export type PaymentTokenRequest = {
+  merchantLogin?: string;
+  orderNumber: string;
+  orderId?: string;
+  bankInvoiceId?: string;
+  redirectUri: string;
+};
+
+// Mirrors `SPaymentTokenResponseModel`: exactly one of `paymentToken` and
+// `paymentTokenId` is set, `tokenExpiration` is a UNIX time in seconds.
+export type PaymentToken = {
+  paymentToken?: string;
+  paymentTokenId?: string;
+  tokenExpiration: number;
+  error?: string;
+};
+
+/**
+ * Acquires a token for the request, e.g. from the merchant backend.
+ * The linked SDK only ships the token models, not an acquisition call.
+ */
+export type PaymentTokenProvider = (
+  request: PaymentTokenRequest
+) => Promise<PaymentToken>;
+
+// Earlier versions persisted tokens here in plaintext; the entry is removed
+// once per JS runtime.
+const LEGACY_STORE_KEY = 'paymentTokens';
+
+// Tokens this close to `tokenExpiration` are treated as expired, so a token
+// never runs out between being handed to the caller and being used.
+const EXPIRY_MARGIN_SECONDS = 30;
+
+let provider: PaymentTokenProvider | null = null;
+
+// Valid tokens by merchant and order. Held in memory only: a token authorises
+// a payment, so it is never written to the unencrypted app store.
+const tokens = new Map<string, PaymentToken>();
+const pending = new Map<string, Promise<PaymentToken>>();
+let legacyCleared = false;
+
+function cacheKey(request: PaymentTokenRequest): string {
+  return JSON.stringify([
+    request.merchantLogin ?? '',
+    request.bankInvoiceId ?? '',
+    request.orderNumber,
+  ]);
+}
+
+function isFresh(token: PaymentToken): boolean {
+  return token.tokenExpiration - EXPIRY_MARGIN_SECONDS > Date.now() / 1000;
+}
+
+function clearLegacyStore() {
+  if (!legacyCleared) {
+    legacyCleared = true;
+    AppYarnPackage.setStoredValue(LEGACY_STORE_KEY, null);
+  }
+}
+
+function dropExpired() {
+  tokens.forEach((token, key) => {
+    if (!isFresh(token)) {
+      tokens.delete(key);
+    }
+  });
+}
+
+export function setPaymentTokenProvider(next: PaymentTokenProvider | null) {
+  provider = next;
+}
+
+/**
+ * Resolves a payment token for the request's merchant, invoice and order. A
+ * cached token is returned until shortly before its `tokenExpiration`; only
+ * then is the provider asked again. Concurrent calls share one acquisition.
+ * Tokens are not kept across app launches.
+ */
+export async function getPaymentToken(
+  request: PaymentTokenRequest,
+  options: { forceRefresh?: boolean } = {}
+): Promise<PaymentToken> {
+  clearLegacyStore();
+  const key = cacheKey(request);
+  if (!options.forceRefresh) {
+    const cached = tokens.get(key);
+    if (cached && isFresh(cached)) {
+      return cached;
+    }
+  }
+
+  const inFlight = pending.get(key);
+  if (inFlight) {
+    return inFlight;
+  }
+  if (!provider) {
+    throw new Error(
+      'No payment token provider is set, call setPaymentTokenProvider first'
+    );
+  }
+  const acquisition = provider(request)
+    .then((token) => {
+      if (token.error || !(token.paymentToken || token.paymentTokenId)) {
+        throw new Error(token.error ?? 'The payment token is empty');
+      }
+      dropExpired();
+      if (isFresh(token)) {
+        tokens.set(key, token);
+      }
+      return token;
+    })
+    .finally(() => pending.delete(key));
+  pending.set(key, acquisition);
+  return acquisition;
+}
+
+/**
+ * Drops the cached token for the request, e.g. after the backend rejected it.
+ */
+export function invalidatePaymentToken(
+  request: PaymentTokenRequest
+): Promise<void> {
+  tokens.delete(cacheKey(request));
+  return Promise.resolve();
+}
+
+export function clearPaymentTokens(): Promise<void> {
+  tokens.clear();
+  legacyCleared = true;
+  AppYarnPackage.setStoredValue(LEGACY_STORE_KEY, null);
+  return Promise.resolve();
+}
@@ -0,0 +1,127 @@
+const TRACES_LIMIT = 50;
+
+/**
+ * Native stages of a payment call, as offsets in ms from `received`:
+ * - `received`: the call reached the native module (always 0)
+ * - `started`: the payment left the queue of the native scheduler
+ * - `mainQueue`: the hop to the main thread ran (iOS)
+ * - `presenterResolved`: the presenting view controller was found (iOS)
+ * - `sdkInvoked`: the SDK's pay method was called
+ * - `completed`: the SDK reported its first state
+ */
+export type PaymentTraceStage =
+  | 'received'
+  | 'started'
+  | 'mainQueue'
+  | 'presenterResolved'
+  | 'sdkInvoked'
+  | 'completed';
+
+export type PaymentTraceMarks = Partial<Record<PaymentTraceStage, number>>;
+
+export type PaymentTraceSpan = {
+  name: string;
+  durationMs: number;
+};
+
+export type PaymentTrace = {
+  sessionId: string;
+  method: string;
+  // The first state the callback received.
+  outcome: string;
+  // Monotonic time of the JS call, see `monotonicNow`.
+  startedAt: number;
+  totalMs: number;
+  marks: PaymentTraceMarks;
+  spans: PaymentTraceSpan[];
+};
+
+type TraceListener = (trace: PaymentTrace) => void;
+
+// Span names by the stage that ends them.
+const SPAN_NAMES: Record<Exclude<PaymentTraceStage, 'received'>, string> = {
+  started: 'queue',
+  mainQueue: 'mainThreadHop',
+  presenterResolved: 'presenterLookup',
+  sdkInvoked: 'dispatch',
+  completed: 'sdk',
+};
+
+const traces: PaymentTrace[] = [];
+const listeners = new Set<TraceListener>();
+
+const perf = (globalThis as any).performance;
+
+// performance.now() is monotonic in Hermes and JSC, Date.now() can jump.
+export const monotonicNow: () => number =
+  typeof perf?.now === 'function' ? () => perf.now() : Date.now;
+
+// JS and native clocks aren't comparable, so the time spent crossing the
+// bridge in both directions is what remains of the JS round trip once the
+// native stages are accounted for.
+function toSpans(
+  totalMs: number,
+  marks: PaymentTraceMarks
+): PaymentTraceSpan[] {
+  const stages = (Object.keys(marks) as PaymentTraceStage[])
+    .filter((stage) => stage !== 'received')
+    .sort((a, b) => (marks[a] as number) - (marks[b] as number));
+  const spans: PaymentTraceSpan[] = [];
+  let previous = 0;
+  stages.forEach((stage) => {
+    const at = marks[stage] as number;
+    spans.push({
+      name: SPAN_NAMES[stage as keyof typeof SPAN_NAMES] ?? stage,
+      durationMs: at - previous,
+    });
+    previous = at;
+  });
+  spans.unshift({
+    name: 'bridge',
+    durationMs: Math.max(0, totalMs - previous),
+  });
+  return spans;
+}
+
+export function recordPaymentTrace(
+  sessionId: string,
+  method: string,
+  outcome: string,
+  startedAt: number,
+  nativeMarks: Object | null | undefined
+) {
+  const totalMs = monotonicNow() - startedAt;
+  const marks = (nativeMarks ?? {}) as PaymentTraceMarks;
+  const trace: PaymentTrace = {
+    sessionId,
+    method,
+    outcome,
+    startedAt,
+    totalMs,
+    marks,
+    spans: toSpans(totalMs, marks),
+  };
+  traces.push(trace);
+  if (traces.length > TRACES_LIMIT) {
+    traces.shift();
+  }
+  listeners.forEach((listener) => listener(trace));
+}
+
+/**
+ * Returns the traces of the most recent payment calls, oldest first.
+ */
+export function getTraces(): PaymentTrace[] {
+  return traces.slice();
+}
+
+export function clearTraces() {
+  traces.length = 0;
+}
+
+export function addTraceListener(listener: TraceListener): () => void {
+  listeners.add(listener);
+  return () => {
+    listeners.delete(listener);
+  };
+}